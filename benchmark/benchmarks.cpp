@@ -0,0 +1,804 @@
+#include "global_allocations.hpp"
+#include <arguably.hpp>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <regex>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+    /// counts the heap allocations performed while the benchmark loop is running
+    class AllocationCounter final {
+    public:
+        explicit AllocationCounter(benchmark::State& state)
+            : m_state{ state },
+              m_start{ num_global_allocations() } { }
+
+        AllocationCounter(const AllocationCounter&) = delete;
+        AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+        ~AllocationCounter() {
+            const auto allocations = num_global_allocations() - m_start;
+            m_state.counters["allocs/iter"] =
+                    benchmark::Counter{ static_cast<double>(allocations), benchmark::Counter::kAvgIterations };
+        }
+
+    private:
+        benchmark::State& m_state;
+        std::size_t m_start;
+    };
+
+    /// the generated names need static storage since the parsers only hold views into them
+    template<std::size_t Count>
+    struct GeneratedNames final {
+        static constexpr auto storage = [] {
+            auto result = std::array<std::array<char, 10>, Count>{};
+            for (std::size_t i = 0; i < Count; ++i) {
+                result[i] = { 'o', 'p', 't', 'i', 'o', 'n', '_' };
+                result[i][7] = static_cast<char>('0' + i / 100);
+                result[i][8] = static_cast<char>('0' + i / 10 % 10);
+                result[i][9] = static_cast<char>('0' + i % 10);
+            }
+            return result;
+        }();
+
+        static constexpr auto views = [] {
+            auto result = std::array<std::string_view, Count>{};
+            for (std::size_t i = 0; i < Count; ++i) {
+                result[i] = std::string_view{ storage[i].data(), storage[i].size() };
+            }
+            return result;
+        }();
+    };
+
+    [[nodiscard]] constexpr auto generated_name(const std::size_t index) {
+        char name[] = "option_000";
+        name[7] = static_cast<char>('0' + index / 100);
+        name[8] = static_cast<char>('0' + index / 10 % 10);
+        name[9] = static_cast<char>('0' + index % 10);
+        return arguably::detail::String{ name };
+    }
+
+    // abbreviations of generated options skip '-' and the reserved 'h'
+    [[nodiscard]] constexpr char generated_abbreviation(std::size_t index) {
+        auto code = index + 1;
+        if (code >= '-') {
+            ++code;
+        }
+        if (code >= 'h') {
+            ++code;
+        }
+        return static_cast<char>(code);
+    }
+
+    enum class GeneratedKind {
+        Named,
+        Positional,
+    };
+
+    template<GeneratedKind Kind, std::size_t Index>
+    struct GeneratedOption final { };
+
+    template<typename Builder>
+    struct GeneratedBuilder final {
+        Builder builder;
+    };
+
+    /// adds a generated option, used in a fold expression to avoid a recursion per option
+    template<typename Builder, GeneratedKind Kind, std::size_t Index>
+    [[nodiscard]] auto operator|(GeneratedBuilder<Builder>&& generated, GeneratedOption<Kind, Index>) {
+        if constexpr (Kind == GeneratedKind::Named) {
+            return GeneratedBuilder{
+                generated.builder.template named<generated_abbreviation(Index), generated_name(Index), "", int>(0)
+            };
+        } else {
+            return GeneratedBuilder{
+                generated.builder.template optionally_named<
+                        generated_abbreviation(Index), generated_name(Index), "", std::string_view>("")
+            };
+        }
+    }
+
+    template<GeneratedKind Kind, std::size_t... Indices>
+    [[nodiscard]] auto make_generated_builder(std::index_sequence<Indices...>) {
+        return (GeneratedBuilder{ arguably::create_parser() } | ... | GeneratedOption<Kind, Indices>{}).builder;
+    }
+
+    /// creates a parser with the given number of generated options (plus the help flag)
+    template<GeneratedKind Kind, std::size_t Count>
+    [[nodiscard]] auto make_generated_parser() {
+        return make_generated_builder<Kind>(std::make_index_sequence<Count>{}).create();
+    }
+
+    [[nodiscard]] constexpr auto generated_subcommand_name(const std::size_t index) {
+        char name[] = "command_00";
+        name[8] = static_cast<char>('0' + index / 10);
+        name[9] = static_cast<char>('0' + index % 10);
+        return arguably::detail::String{ name };
+    }
+
+    template<std::size_t Index>
+    struct GeneratedSubcommand final { };
+
+    template<typename Builder>
+    struct GeneratedSubcommands final {
+        Builder builder;
+    };
+
+    template<typename Builder, std::size_t Index>
+    [[nodiscard]] auto operator|(GeneratedSubcommands<Builder>&& generated, GeneratedSubcommand<Index>) {
+        return GeneratedSubcommands{ generated.builder.template subcommand<generated_subcommand_name(Index)>(
+                make_generated_builder<GeneratedKind::Named>(std::make_index_sequence<5>{})
+        ) };
+    }
+
+    /// creates subcommands with 5 generated options each
+    template<std::size_t... Indices>
+    [[nodiscard]] auto make_generated_subcommands(std::index_sequence<Indices...>) {
+        return (GeneratedSubcommands{ arguably::create_subcommands() } | ... | GeneratedSubcommand<Indices>{})
+                .builder.create();
+    }
+
+    /// owns the strings of a generated argument vector
+    class Arguments final {
+    public:
+        explicit Arguments(std::vector<std::string> arguments) : m_arguments{ std::move(arguments) } {
+            m_arguments.insert(m_arguments.begin(), "a.out");
+            for (const auto& argument : m_arguments) {
+                m_argv.push_back(argument.c_str());
+            }
+            m_argv.push_back(nullptr);
+        }
+
+        [[nodiscard]] const char** argv() {
+            return m_argv.data();
+        }
+
+    private:
+        std::vector<std::string> m_arguments;
+        std::vector<const char*> m_argv;
+    };
+
+    [[nodiscard]] auto make_mixed_parser() {
+        return arguably::create_parser()
+                .flag<'a', "all", "">()
+                .flag<'t', "tree", "">()
+                .flag<'b', "binary", "">()
+                .flag<'z', "zip", "">()
+                .flag<'x', "extract", "">()
+                .named<'o', "output", "the output file", std::string>("a.out")
+                .named<'n', "count", "number of repetitions", int>(1)
+                .named<'u', "limit", "upper limit", unsigned long long>(0)
+                .named<'r', "ratio", "ratio of something", double>(0.0)
+                .optionally_named<'i', "input", "the input file", std::string_view>("-")
+                .create();
+    }
+
+    /// reuses a single parser to measure the steady state
+    template<typename Factory>
+    void run_parse_benchmark(benchmark::State& state, Arguments& arguments) {
+        auto parser = Factory::create();
+        const auto allocations = AllocationCounter{ state };
+        for (auto _ : state) {
+            parser.parse_fresh(arguments.argv());
+            benchmark::DoNotOptimize(parser);
+        }
+    }
+
+    /// constructs a new parser for every parse
+    template<typename Factory>
+    void run_construct_and_parse_benchmark(benchmark::State& state, Arguments& arguments) {
+        const auto allocations = AllocationCounter{ state };
+        for (auto _ : state) {
+            auto parser = Factory::create();
+            parser.parse(arguments.argv());
+            benchmark::DoNotOptimize(parser);
+        }
+    }
+
+    struct MixedParserFactory final {
+        [[nodiscard]] static auto create() {
+            return make_mixed_parser();
+        }
+    };
+
+    template<GeneratedKind Kind, std::size_t Count>
+    struct GeneratedParserFactory final {
+        [[nodiscard]] static auto create() {
+            return make_generated_parser<Kind, Count>();
+        }
+    };
+}// namespace
+
+template<std::size_t NumOptions>
+static void BM_NameLookup(benchmark::State& state) {
+    static constexpr auto table = arguably::detail::make_perfect_hash_table(GeneratedNames<NumOptions>::views);
+    // copies of the names so that the lookup cannot compare pointers only
+    const auto names = std::vector<std::string>{ GeneratedNames<NumOptions>::views.begin(),
+                                                 GeneratedNames<NumOptions>::views.end() };
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(names[i]));
+        i = (i + 1 == names.size() ? 0 : i + 1);
+    }
+}
+
+BENCHMARK(BM_NameLookup<5>);
+BENCHMARK(BM_NameLookup<50>);
+BENCHMARK(BM_NameLookup<100>);
+BENCHMARK(BM_NameLookup<250>);
+BENCHMARK(BM_NameLookup<500>);
+
+static void BM_ParseFlagCluster(benchmark::State& state) {
+    auto arguments = Arguments{
+        std::vector<std::string>(static_cast<std::size_t>(state.range(0)), "-atbzx")
+    };
+    run_parse_benchmark<MixedParserFactory>(state, arguments);
+}
+
+BENCHMARK(BM_ParseFlagCluster)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_ParseLongNameWithValue(benchmark::State& state) {
+    auto arguments = Arguments{
+        std::vector<std::string>(static_cast<std::size_t>(state.range(0)), "--output=some/path/to/a/file.txt")
+    };
+    run_parse_benchmark<MixedParserFactory>(state, arguments);
+}
+
+BENCHMARK(BM_ParseLongNameWithValue)->Arg(1)->Arg(16)->Arg(256);
+
+static void BM_ParseNumericValues(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-n", "12345", "--limit=18446744073709551615", "--ratio", "3.14159265358979", "-n-42" }
+    };
+    run_parse_benchmark<MixedParserFactory>(state, arguments);
+}
+
+BENCHMARK(BM_ParseNumericValues);
+
+static void BM_ParseMixed(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-atb", "--output", "result.txt", "-n7", "--ratio=0.5", "input.txt", "-zx" }
+    };
+    run_parse_benchmark<MixedParserFactory>(state, arguments);
+}
+
+BENCHMARK(BM_ParseMixed);
+
+/// the same command line as BM_ParseMixed, with reset() and parse() instead of parse_fresh()
+static void BM_ParseWithoutObserver(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-atb", "--output", "result.txt", "-n7", "--ratio=0.5", "input.txt", "-zx" }
+    };
+    auto parser = make_mixed_parser();
+    for (auto _ : state) {
+        parser.reset();
+        parser.parse(arguments.argv());
+        benchmark::DoNotOptimize(parser);
+    }
+}
+
+BENCHMARK(BM_ParseWithoutObserver);
+
+/// arguably::Observer itself does nothing and should be as fast as BM_ParseWithoutObserver
+template<typename Observer>
+static void BM_ParseWithObserver(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-atb", "--output", "result.txt", "-n7", "--ratio=0.5", "input.txt", "-zx" }
+    };
+    auto parser = make_mixed_parser();
+    auto observer = Observer{};
+    for (auto _ : state) {
+        parser.reset();
+        parser.parse(arguments.argv(), observer);
+        benchmark::DoNotOptimize(parser);
+    }
+    benchmark::DoNotOptimize(observer);
+}
+
+BENCHMARK(BM_ParseWithObserver<arguably::Observer>);
+BENCHMARK(BM_ParseWithObserver<arguably::CountingObserver>);
+BENCHMARK(BM_ParseWithObserver<arguably::TimingObserver>);
+
+template<typename PathType>
+static void BM_ParsePathOptions(benchmark::State& state) {
+    auto parser = arguably::create_parser()
+                          .template named<'a', "source", "", PathType>({})
+                          .template named<'b', "build", "", PathType>({})
+                          .template named<'c', "cache", "", PathType>({})
+                          .template named<'d', "data", "", PathType>({})
+                          .template named<'e', "export", "", PathType>({})
+                          .template named<'f', "fonts", "", PathType>({})
+                          .template named<'g', "generated", "", PathType>({})
+                          .template named<'i', "include", "", PathType>({})
+                          .create();
+    auto paths = std::vector<std::string>{};
+    for (const auto name : { "source", "build", "cache", "data", "export", "fonts", "generated", "include" }) {
+        paths.push_back(std::string{ "--" } + name + "=/home/user/projects/some_project/" + name);
+    }
+    auto arguments = Arguments{ std::move(paths) };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        parser.parse_fresh(arguments.argv());
+        benchmark::DoNotOptimize(parser);
+    }
+}
+
+BENCHMARK(BM_ParsePathOptions<std::string>);
+BENCHMARK(BM_ParsePathOptions<std::string_view>);
+BENCHMARK(BM_ParsePathOptions<std::span<const char>>);
+
+static void BM_ParseRepeatedOption(benchmark::State& state) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .multi<'I', "include", "", std::string_view>()
+                          .multi<'f', "file", "", std::string_view>()
+                          .create();
+    const auto repetitions = static_cast<std::size_t>(state.range(0));
+    auto argument_list = std::vector<std::string>{};
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        argument_list.emplace_back(i % 2 == 0 ? "-I" : "--file");
+        argument_list.push_back("src/module_" + std::to_string(i));
+    }
+    auto arguments = Arguments{ std::move(argument_list) };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        auto fresh_parser = parser;
+        fresh_parser.parse(arguments.argv());
+        benchmark::DoNotOptimize(fresh_parser);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_ParseRepeatedOption)->RangeMultiplier(10)->Range(100, 100'000)->Complexity(benchmark::oN);
+
+static void BM_ParseRestParameter(benchmark::State& state) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string_view>("a.out")
+                          .optionally_named<'c', "command", "", std::string_view>("")
+                          .rest<'f', "files", "">()
+                          .create();
+    auto argument_list = std::vector<std::string>{ "-v", "--output=result.txt", "rm" };
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        argument_list.push_back("src/module_" + std::to_string(i) + ".cpp");
+    }
+    auto arguments = Arguments{ std::move(argument_list) };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        parser.parse_fresh(arguments.argv());
+        benchmark::DoNotOptimize(parser);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_ParseRestParameter)->RangeMultiplier(10)->Range(100, 1'000'000)->Complexity();
+
+/// one million arguments of all kinds
+static void BM_ParseHugeArgv(benchmark::State& state) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .flag<'x', "extract", "">()
+                          .multi<'I', "include", "", std::string_view>()
+                          .multi<'D', "define", "", std::string_view>()
+                          .multi<'n', "number", "", int>()
+                          .rest<'f', "files", "">()
+                          .create();
+    auto argument_list = std::vector<std::string>{};
+    const auto num_arguments = static_cast<std::size_t>(state.range(0));
+    while (argument_list.size() < num_arguments) {
+        const auto i = std::to_string(argument_list.size());
+        argument_list.push_back("-vx");
+        argument_list.push_back("-I/usr/include/library_" + i);
+        argument_list.push_back("--include=/opt/include/library_" + i);
+        argument_list.push_back("--define");
+        argument_list.push_back("SOME_MACRO_" + i);
+        argument_list.push_back("-n");
+        argument_list.push_back(i);
+    }
+    argument_list.push_back("file.cpp");
+    auto arguments = Arguments{ std::move(argument_list) };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        parser.parse_fresh(arguments.argv());
+        benchmark::DoNotOptimize(parser);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ParseHugeArgv)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_ParseCommandLineString(benchmark::State& state, const std::string_view command_line) {
+    auto parser = make_mixed_parser();
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        parser.parse_fresh(command_line);
+        benchmark::DoNotOptimize(parser);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_ParseCommandLineString, unquoted, "-atb --output result.txt -n7 --ratio=0.5 input.txt -zx");
+BENCHMARK_CAPTURE(BM_ParseCommandLineString, quoted, "-atb --output 'result.txt' -n7 --ratio=0.5 \"input.txt\" -zx");
+BENCHMARK_CAPTURE(
+        BM_ParseCommandLineString,
+        escaped,
+        R"(-atb --output result\ file.txt -n7 --ratio=0.5 "my \"input\".txt" -zx)"
+);
+
+/// a request-scoped arena: parser and result live in a buffer that is released after every request
+static void BM_ConstructAndParseWithArena(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-v", "--output=a/path/that/does/not/fit/into/the/small/string/buffer.txt", "-I/usr/include/some/path",
+          "-I/usr/local/include/some/other/path", "input.txt" }
+    };
+    auto buffer = std::array<std::byte, 16 * 1024>{};
+    auto resource = std::pmr::monotonic_buffer_resource{ buffer.data(), buffer.size() };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        {
+            auto parser = arguably::create_parser()
+                                  .flag<'v', "verbose", "">()
+                                  .named<'o', "output", "", std::pmr::string>(std::pmr::string{ &resource })
+                                  .multi<'I', "include", "", std::pmr::string>()
+                                  .optionally_named<'i', "input", "", std::string_view>("-")
+                                  .create(&resource);
+            parser.parse(arguments.argv());
+            benchmark::DoNotOptimize(parser);
+        }
+        resource.release();
+    }
+}
+
+BENCHMARK(BM_ConstructAndParseWithArena);
+
+static void BM_ConstructAndParseMixed(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "-atb", "--output", "result.txt", "-n7", "--ratio=0.5", "input.txt", "-zx" }
+    };
+    run_construct_and_parse_benchmark<MixedParserFactory>(state, arguments);
+}
+
+BENCHMARK(BM_ConstructAndParseMixed);
+
+namespace {
+    /// a value type that is expensive to construct
+    template<bool Lazy>
+    struct Pattern final {
+        std::regex regex;
+    };
+}// namespace
+
+template<bool Lazy>
+struct arguably::converter<Pattern<Lazy>> {
+    static constexpr bool lazy = Lazy;
+
+    [[nodiscard]] static bool convert(const std::string_view input, Pattern<Lazy>& target) {
+        try {
+            target.regex = std::regex{ input.begin(), input.end() };
+            return true;
+        } catch (const std::regex_error&) {
+            return false;
+        }
+    }
+};
+
+/// none of the values is accessed, so a lazy converter never constructs them
+template<bool Lazy>
+static void BM_ParseExpensiveValues(benchmark::State& state) {
+    const auto schema = arguably::create_parser()
+                                .named<'i', "include", "", Pattern<Lazy>>({})
+                                .template named<'e', "exclude", "", Pattern<Lazy>>({})
+                                .template named<'m', "match", "", Pattern<Lazy>>({})
+                                .template flag<'v', "verbose", "">()
+                                .create_schema();
+    auto arguments = Arguments{
+        { "--include=[a-z_]+\\.(cpp|hpp)", "--exclude=^build/.*", "-m", "(foo|bar)[0-9]{2,4}", "-v" }
+    };
+    auto parsed = schema.parse(arguments.argv());
+    for (auto _ : state) {
+        schema.parse_into(parsed, arguments.argv());
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_ParseExpensiveValues<false>);
+BENCHMARK(BM_ParseExpensiveValues<true>);
+
+static void set_environment_variable(const char* const name, const char* const value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+/// fills the environment with the given number of unrelated variables, followed by the ones the benchmarks bind to
+static void prepare_environment(const int num_variables) {
+    for (auto i = 0; i < num_variables; ++i) {
+        const auto name = "ARGUABLY_BENCH_UNRELATED_" + std::to_string(i);
+        set_environment_variable(name.c_str(), "some value that nobody looks at");
+    }
+    set_environment_variable("ARGUABLY_BENCH_OUTPUT", "result.txt");
+    set_environment_variable("ARGUABLY_BENCH_COUNT", "7");
+    set_environment_variable("ARGUABLY_BENCH_RATIO", "0.5");
+    set_environment_variable("ARGUABLY_BENCH_VERBOSE", "1");
+}
+
+static void BM_ParseWithEnvironment(benchmark::State& state) {
+    prepare_environment(static_cast<int>(state.range(0)));
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .named<'o', "output", "", std::string_view>("a.out")
+                                .named<'n', "count", "", int>(1)
+                                .named<'r', "ratio", "", double>(1.0)
+                                .optionally_named<'i', "input", "", std::string_view>("-")
+                                .env<'v', "ARGUABLY_BENCH_VERBOSE">()
+                                .env<'o', "ARGUABLY_BENCH_OUTPUT">()
+                                .env<'n', "ARGUABLY_BENCH_COUNT">()
+                                .env<'r', "ARGUABLY_BENCH_RATIO">()
+                                .create_schema();
+    auto arguments = Arguments{ { "input.txt" } };
+    auto parsed = schema.parse(arguments.argv());
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        schema.parse_into(parsed, arguments.argv());
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_ParseWithEnvironment)->Arg(2'000);
+
+/// the same as BM_ParseWithEnvironment, but with one getenv() call per option
+static void BM_ParseWithGetenvPerOption(benchmark::State& state) {
+    prepare_environment(static_cast<int>(state.range(0)));
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .named<'o', "output", "", std::string_view>("a.out")
+                                .named<'n', "count", "", int>(1)
+                                .named<'r', "ratio", "", double>(1.0)
+                                .optionally_named<'i', "input", "", std::string_view>("-")
+                                .create_schema();
+    auto arguments = Arguments{ { "input.txt" } };
+    auto parsed = schema.parse(arguments.argv());
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        schema.parse_into(parsed, arguments.argv());
+        for (const auto variable :
+             { "ARGUABLY_BENCH_VERBOSE", "ARGUABLY_BENCH_OUTPUT", "ARGUABLY_BENCH_COUNT", "ARGUABLY_BENCH_RATIO" }) {
+            benchmark::DoNotOptimize(std::getenv(variable));
+        }
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_ParseWithGetenvPerOption)->Arg(2'000);
+
+static void BM_SharedSchemaParse(benchmark::State& state) {
+    static const auto schema = arguably::create_parser()
+                                       .flag<'v', "verbose", "">()
+                                       .named<'o', "output", "", std::string>("a.out")
+                                       .named<'n', "count", "", int>(1)
+                                       .create_schema();
+    auto arguments = Arguments{
+        { "-v", "--output", "result.txt", "-n7" }
+    };
+    auto parsed = schema.parse(arguments.argv());
+    for (auto _ : state) {
+        schema.parse_into(parsed, arguments.argv());
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_SharedSchemaParse)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ParseLines(benchmark::State& state) {
+    static const auto schema = arguably::create_parser()
+                                       .flag<'v', "verbose", "">()
+                                       .named<'o', "output", "", std::string_view>("a.out")
+                                       .named<'n', "count", "", int>(1)
+                                       .optionally_named<'i', "input", "", std::string_view>("")
+                                       .create_schema();
+    const auto num_lines = static_cast<std::size_t>(state.range(0));
+    auto manifest = std::string{};
+    for (std::size_t i = 0; i < num_lines; ++i) {
+        manifest += "-v --output=result_" + std::to_string(i) + ".txt -n " + std::to_string(i % 1000) + " input.txt\n";
+    }
+    const auto num_threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state) {
+        auto results = schema.parse_lines(manifest, num_threads);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(manifest.size()));
+}
+
+BENCHMARK(BM_ParseLines)
+        ->ArgsProduct({ { 100'000, 1'000'000 }, { 1, 2, 4, 8 } })
+        ->Args({ 10'000'000, 1 })
+        ->Args({ 10'000'000, 8 })
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+template<std::size_t NumPositionals>
+static void BM_ParsePositionals(benchmark::State& state) {
+    auto positionals = std::vector<std::string>{};
+    for (std::size_t i = 0; i < NumPositionals; ++i) {
+        positionals.push_back("file_" + std::to_string(i) + ".txt");
+    }
+    auto arguments = Arguments{ std::move(positionals) };
+    run_parse_benchmark<GeneratedParserFactory<GeneratedKind::Positional, NumPositionals>>(state, arguments);
+}
+
+BENCHMARK(BM_ParsePositionals<8>);
+BENCHMARK(BM_ParsePositionals<32>);
+BENCHMARK(BM_ParsePositionals<64>);
+
+/// parses the value of the last declared option to measure how the parse cost grows with the parser size
+template<std::size_t NumOptions>
+static void BM_ParseParserSize(benchmark::State& state) {
+    auto arguments = Arguments{
+        { "--" + std::string{ GeneratedNames<NumOptions>::views.back() } + "=42" }
+    };
+    run_parse_benchmark<GeneratedParserFactory<GeneratedKind::Named, NumOptions>>(state, arguments);
+}
+
+BENCHMARK(BM_ParseParserSize<5>);
+BENCHMARK(BM_ParseParserSize<25>);
+BENCHMARK(BM_ParseParserSize<50>);
+BENCHMARK(BM_ParseParserSize<100>);
+
+/// 20 subcommands with 5 options each, compare with BM_ParseFlatParserInsteadOfSubcommands
+static void BM_ParseSubcommand(benchmark::State& state) {
+    static const auto commands = make_generated_subcommands(std::make_index_sequence<20>{});
+    auto arguments = Arguments{ { "command_19", "--option_004=42", "--option_000", "7" } };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        auto parsed = commands.parse(arguments.argv());
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_ParseSubcommand);
+
+/// all options of the 20 subcommands of BM_ParseSubcommand in a single parser
+static void BM_ParseFlatParserInsteadOfSubcommands(benchmark::State& state) {
+    static const auto parser = make_generated_parser<GeneratedKind::Named, 100>();
+    auto arguments = Arguments{ { "--option_099=42", "--option_000", "7" } };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        auto parsed = parser.schema().parse(arguments.argv());
+        benchmark::DoNotOptimize(parsed);
+    }
+}
+
+BENCHMARK(BM_ParseFlatParserInsteadOfSubcommands);
+
+static void BM_ParseResponseFile(benchmark::State& state) {
+    static const auto schema = arguably::create_parser()
+                                       .flag<'v', "verbose", "">()
+                                       .named<'o', "output", "", std::string_view>("a.out")
+                                       .named<'n', "count", "", int>(1)
+                                       .response_files()
+                                       .create_schema();
+    const auto path = std::filesystem::temp_directory_path() / "arguably_benchmark_response_file.txt";
+    const auto size = static_cast<std::size_t>(state.range(0)) * 1024 * 1024;
+    {
+        const auto line = std::string_view{ "-v --output=result.txt -n 7\n" };
+        auto stream = std::ofstream{ path, std::ios::binary };
+        for (std::size_t written = 0; written < size; written += line.size()) {
+            stream << line;
+        }
+    }
+    const auto response_argument = "@" + path.string();
+    auto arguments = Arguments{ { response_argument } };
+    auto parsed = schema.parse(arguments.argv());
+    {
+        const auto counter = AllocationCounter{ state };
+        for (auto _ : state) {
+            schema.parse_into(parsed, arguments.argv());
+            benchmark::DoNotOptimize(parsed);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_ParseResponseFile)->Arg(1)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void BM_ParseConfigFile(benchmark::State& state) {
+    static const auto schema = arguably::create_parser()
+                                       .flag<'v', "verbose", "">()
+                                       .named<'o', "output", "", std::string_view>("a.out")
+                                       .named<'n', "count", "", int>(1)
+                                       .named<'r', "ratio", "", double>(1.0)
+                                       .create_schema();
+    const auto path = std::filesystem::temp_directory_path() / "arguably_benchmark_config_file.conf";
+    const auto size = static_cast<std::size_t>(state.range(0)) * 1024 * 1024;
+    {
+        const auto lines =
+                std::string_view{ "# generated\nverbose = true\noutput = result.txt\ncount = 7\nratio=0.5\n" };
+        auto stream = std::ofstream{ path, std::ios::binary };
+        for (std::size_t written = 0; written < size; written += lines.size()) {
+            stream << lines;
+        }
+    }
+    const auto config_path = path.string();
+    auto arguments = Arguments{ { "--count", "3" } };
+    auto parsed = schema.parse(arguments.argv());
+    {
+        const auto counter = AllocationCounter{ state };
+        for (auto _ : state) {
+            schema.parse_into(parsed, arguments.argv());
+            schema.parse_config(parsed, config_path.c_str());
+            benchmark::DoNotOptimize(parsed);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_ParseConfigFile)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_Get(benchmark::State& state) {
+    auto parser = make_mixed_parser();
+    auto arguments = Arguments{ { "--output=result.txt", "-n", "42" } };
+    parser.parse(arguments.argv());
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.get<'o'>());
+        benchmark::DoNotOptimize(parser.get<'n'>());
+    }
+}
+
+BENCHMARK(BM_Get);
+
+static void BM_PrintHelp(benchmark::State& state) {
+    const auto parser = make_mixed_parser();
+    auto stream = std::stringstream{};
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        stream.str({});
+        parser.print_help(stream);
+        benchmark::DoNotOptimize(stream);
+    }
+}
+
+BENCHMARK(BM_PrintHelp);
+
+static void BM_PrintHelpToFile(benchmark::State& state) {
+    const auto parser = make_mixed_parser();
+    const auto file = std::fopen("/dev/null", "wb");
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        parser.print_help(file);
+    }
+    std::fclose(file);
+}
+
+BENCHMARK(BM_PrintHelpToFile);
+
+static void BM_Complete(benchmark::State& state) {
+    const auto parser = make_generated_parser<GeneratedKind::Named, 100>();
+    const auto file = std::fopen("/dev/null", "wb");
+    auto arguments = Arguments{ { "--__complete", "2", "a.out", "--option_000=1", "--option_04" } };
+    const auto allocations = AllocationCounter{ state };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.complete(arguments.argv(), file));
+    }
+    std::fclose(file);
+}
+
+BENCHMARK(BM_Complete);
+
+BENCHMARK_MAIN();
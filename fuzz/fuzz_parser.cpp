@@ -0,0 +1,290 @@
+// Fuzz target for the parsing state machine. The first byte of an input selects one of the schemas below and how
+// the rest of the input is passed to it: as an argument vector (split at '\0'), as a command line string, or as
+// lines for parse_lines(). Every argument is a separate heap allocation of its exact size, so AddressSanitizer
+// reports any read past its end. With libFuzzer, every parse also has to finish within a deadline that grows
+// linearly with the number of tokens of the input, otherwise the input is reported as a crash.
+//
+// With libFuzzer, the entry point is LLVMFuzzerTestOneInput(). Defining ARGUABLY_FUZZ_STANDALONE adds a main()
+// that replays the files given as arguments, or runs a fixed set of generated inputs if there are none. The
+// standalone binary only checks for crashes and sanitizer reports: it runs under ctest in debug, coverage and
+// sanitizer builds, where a wall-clock deadline would fail at random.
+
+#include <arguably.hpp>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef ARGUABLY_FUZZ_STANDALONE
+#include <fstream>
+#include <iterator>
+#include <random>
+#endif
+
+namespace {
+    volatile std::size_t sink = 0;
+
+    /// reads every byte a value refers to
+    template<typename T>
+    void touch(const T& value) {
+        if constexpr (std::same_as<T, const char*>) {
+            sink = sink + std::strlen(value);
+        } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+            for (const auto c : std::string_view{ value }) {
+                sink = sink + static_cast<unsigned char>(c);
+            }
+        } else if constexpr (std::ranges::range<T>) {
+            for (const auto& element : value) {
+                touch(element);
+            }
+        } else {
+            sink = sink + static_cast<std::size_t>(value);
+        }
+    }
+
+    template<char... Abbreviations>
+    struct ValueReader final {
+        template<typename Result>
+        static void read(const Result& parsed) {
+            (touch(parsed.template get<Abbreviations>()), ...);
+        }
+    };
+
+    /// flags, clusters and numeric conversions
+    const auto mixed_schema = arguably::create_parser()
+                                      .flag<'a', "all", "">()
+                                      .flag<'t', "tree", "">()
+                                      .flag<'b', "binary", "">()
+                                      .named<'o', "output", "", std::string>("a.out")
+                                      .named<'n', "count", "", int>(1)
+                                      .named<'r', "ratio", "", double>(0.0)
+                                      .named<'y', "yes", "", bool>(false)
+                                      .optionally_named<'i', "input", "", std::string_view>("-")
+                                      .optionally_named<'s', "second", "", std::string>("-")
+                                      .multi<'I', "include", "", std::string_view>()
+                                      .create_schema();
+    using MixedReader = ValueReader<'a', 't', 'b', 'o', 'n', 'r', 'y', 'i', 's', 'I'>;
+
+    /// a rest parameter that takes everything after the positionals
+    const auto rest_schema = arguably::create_parser()
+                                     .flag<'v', "verbose", "">()
+                                     .named<'c', "count", "", unsigned long long>(0)
+                                     .optionally_named<'f', "first", "", std::string_view>("")
+                                     .multi<'D', "define", "", std::string>()
+                                     .rest<'R', "rest", "">()
+                                     .create_schema();
+    using RestReader = ValueReader<'v', 'c', 'f', 'D', 'R'>;
+
+    /// many positionals, where the cursor has to skip the ones that are given by name
+    const auto positional_schema = arguably::create_parser()
+                                           .flag<'x', "x", "">()
+                                           .optionally_named<'0', "p0", "", std::string_view>("")
+                                           .optionally_named<'1', "p1", "", std::string_view>("")
+                                           .optionally_named<'2', "p2", "", std::string_view>("")
+                                           .optionally_named<'3', "p3", "", std::string_view>("")
+                                           .optionally_named<'4', "p4", "", int>(0)
+                                           .optionally_named<'5', "p5", "", std::string_view>("")
+                                           .optionally_named<'6', "p6", "", std::string_view>("")
+                                           .optionally_named<'7', "p7", "", std::string_view>("")
+                                           .create_schema();
+    using PositionalReader = ValueReader<'x', '0', '1', '2', '3', '4', '5', '6', '7'>;
+
+    /// The arguments of an input, split at '\0'. The schemas do not expand response files, so arguments starting with
+    /// '@' cannot make the parser read arbitrary files (or block on /dev/stdin).
+    class ArgumentVector final {
+    public:
+        explicit ArgumentVector(const std::string_view input) {
+            m_argv.push_back("fuzz");
+            for (auto rest = input;;) {
+                const auto end = std::min(rest.find('\0'), rest.size());
+                auto& argument = m_arguments.emplace_back(std::make_unique<char[]>(end + 1));
+                std::memcpy(argument.get(), rest.data(), end);
+                m_argv.push_back(argument.get());
+                if (end == rest.size()) {
+                    break;
+                }
+                rest.remove_prefix(end + 1);
+            }
+            m_argv.push_back(nullptr);
+        }
+
+        [[nodiscard]] const char** argv() {
+            return m_argv.data();
+        }
+
+    private:
+        std::vector<std::unique_ptr<char[]>> m_arguments;
+        std::vector<const char*> m_argv;
+    };
+
+    enum class Mode {
+        ArgumentVector,
+        CommandLine,
+        Lines,
+    };
+
+    template<typename Reader>
+    void parse(const auto& schema, const Mode mode, const std::string_view input) {
+        switch (mode) {
+            case Mode::ArgumentVector: {
+                auto arguments = ArgumentVector{ input };
+                Reader::read(schema.parse(arguments.argv()));
+                break;
+            }
+            case Mode::CommandLine: {
+                // an exact copy, so that reading past the end of the command line is detected
+                const auto copy = std::make_unique<char[]>(input.size());
+                std::memcpy(copy.get(), input.data(), input.size());
+                Reader::read(schema.parse(std::string_view{ copy.get(), input.size() }));
+                break;
+            }
+            case Mode::Lines:
+                for (const auto& parsed : schema.parse_lines(input, 1)) {
+                    Reader::read(parsed);
+                }
+                break;
+        }
+    }
+
+    void parse(const std::uint8_t selector, const std::string_view input) {
+        const auto mode = static_cast<Mode>(selector % 3);
+        switch (selector / 3 % 3) {
+            case 0:
+                parse<MixedReader>(mixed_schema, mode, input);
+                break;
+            case 1:
+                parse<RestReader>(rest_schema, mode, input);
+                break;
+            default:
+                parse<PositionalReader>(positional_schema, mode, input);
+                break;
+        }
+    }
+
+#ifndef ARGUABLY_FUZZ_STANDALONE
+    /// the number of arguments or words of an input in every mode, i.e. the runs of characters between '\0' and
+    /// whitespace
+    [[nodiscard]] std::size_t count_tokens(const std::string_view input) {
+        auto count = std::size_t{ 0 };
+        auto in_token = false;
+        for (const auto c : input) {
+            const auto is_separator = (c == '\0' or c == ' ' or c == '\t' or c == '\n' or c == '\r');
+            count += (not is_separator and not in_token) ? 1 : 0;
+            in_token = not is_separator;
+        }
+        return count;
+    }
+
+    /// Scales with the number of tokens, plus a small allowance per byte for scanning long words and flag clusters.
+    /// That is generous enough for sanitizer builds, but far below what a quadratic parse of a long input would need.
+    [[nodiscard]] std::chrono::nanoseconds deadline(const std::string_view input) {
+        return std::chrono::milliseconds{ 5 } + std::chrono::microseconds{ 20 } * count_tokens(input)
+               + std::chrono::nanoseconds{ 200 } * input.size();
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds measure(const std::uint8_t selector, const std::string_view input) {
+        const auto start = std::chrono::steady_clock::now();
+        parse(selector, input);
+        return std::chrono::steady_clock::now() - start;
+    }
+#endif
+}// namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* const data, const std::size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    const auto input = std::string_view{ reinterpret_cast<const char*>(data) + 1, size - 1 };
+#ifdef ARGUABLY_FUZZ_STANDALONE
+    parse(data[0], input);
+#else
+    // a single slow run can be bad luck with the scheduler, a second one cannot
+    if (measure(data[0], input) > deadline(input) and measure(data[0], input) > deadline(input)) {
+        std::fprintf(stderr, "parsing %zu tokens (%zu bytes) took longer than %lld ns\n", count_tokens(input), size,
+                     static_cast<long long>(deadline(input).count()));
+        std::abort();
+    }
+#endif
+    return 0;
+}
+
+#ifdef ARGUABLY_FUZZ_STANDALONE
+namespace {
+    [[nodiscard]] std::string read_file(const char* const path) {
+        auto file = std::ifstream{ path, std::ios::binary };
+        return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    }
+
+    void run(const std::string_view input) {
+        static_cast<void>(LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size()));
+    }
+
+    [[nodiscard]] std::string repeat(const std::string_view text, const std::size_t count) {
+        auto result = std::string{};
+        for (std::size_t i = 0; i < count; ++i) {
+            result += text;
+        }
+        return result;
+    }
+
+    /// long inputs that stress a single part of the state machine, for every schema and mode
+    void run_pathological_inputs() {
+        const std::string_view parts[] = {
+            std::string_view{ "-\0", 2 },
+            std::string_view{ "--\0", 3 },
+            std::string_view{ "-atb", 4 },
+            std::string_view{ "-I\0x\0", 5 },
+            std::string_view{ "--include=x\0", 12 },
+            std::string_view{ "p\0", 2 },
+            std::string_view{ "\0", 1 },
+            std::string_view{ "\"a b\" 'c' d\\ e ", 16 },
+            std::string_view{ "x\n", 2 },
+        };
+        for (const auto part : parts) {
+            const auto body = repeat(part, 20'000);
+            for (std::uint8_t selector = 0; selector < 9; ++selector) {
+                run(static_cast<char>(selector) + body);
+            }
+        }
+    }
+
+    /// random inputs from an alphabet that is likely to hit the interesting transitions
+    void run_generated_inputs(const std::size_t count) {
+        using namespace std::string_view_literals;
+        static constexpr auto alphabet = "-----===\0\0\0\0 \t\n\"'\\@atbonrysiIvcfDRx01234567h5."sv;
+        static_assert(alphabet.size() == 46);
+        auto generator = std::mt19937{ 42 };
+        auto size_distribution = std::uniform_int_distribution<std::size_t>{ 0, 64 };
+        auto char_distribution = std::uniform_int_distribution<std::size_t>{ 0, alphabet.size() - 1 };
+        auto input = std::string{};
+        for (std::size_t i = 0; i < count; ++i) {
+            input.assign(1, static_cast<char>(i % 9));
+            for (auto size = size_distribution(generator); size > 0; --size) {
+                input += alphabet[char_distribution(generator)];
+            }
+            run(input);
+        }
+    }
+}// namespace
+
+int main(const int argc, char** const argv) {
+    if (argc > 1) {
+        for (auto i = 1; i < argc; ++i) {
+            run(read_file(argv[i]));
+        }
+        return 0;
+    }
+    run_pathological_inputs();
+    run_generated_inputs(200'000);
+    std::puts("all inputs parsed");
+}
+#endif
@@ -1,24 +1,59 @@
 #pragma once
 
 #include <algorithm>
-#include <any>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <concepts>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <fmt/core.h>
-#include <fmt/ostream.h>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <ostream>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ARGUABLY_USE_MMAP
+#endif
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define ARGUABLY_USE_POSIX_WRITE
+#endif
+
+#if defined(__APPLE__)
+#include <crt_externs.h>
+#define ARGUABLY_USE_ENVIRON
+#elif __has_include(<unistd.h>)
+extern "C" char** environ;
+#define ARGUABLY_USE_ENVIRON
+#endif
+
 namespace arguably {
     namespace result {
         struct MissingArgument {
@@ -27,17 +62,137 @@ namespace arguably {
 
         struct NothingParsedYet { };
         struct UnknownOption {
-            std::variant<char, std::string> option;
+            std::variant<char, std::pmr::string> option;
         };
         struct CannotParseAgain { };
         struct Okay { };
         struct ExcessUnnamedArguments { };
         struct CannotSetValueOfFlag {
-            std::string option;
+            std::pmr::string option;
         };
         struct ArgumentTypeMismatch { };
+        struct CannotOpenResponseFile {
+            std::pmr::string path;
+        };
+        struct UnterminatedQuote { };
+        /// the command line was a completion request, the completions have been written to stdout
+        struct CompletionWritten { };
+        struct CannotOpenConfigFile {
+            std::pmr::string path;
+        };
+        /// the first argument is not the name of a subcommand (the name is empty if there is no first argument)
+        struct UnknownSubcommand {
+            std::pmr::string name;
+        };
+        /// a line of a config file that is neither empty, nor a comment, nor a "name = value" pair
+        struct InvalidConfigLine {
+            std::size_t line;
+        };
     }// namespace result
 
+    /// the shells for which completion scripts can be generated
+    enum class Shell {
+        Bash,
+        Zsh,
+        Fish,
+    };
+
+    namespace detail {
+        template<typename T>
+        concept FromCharsInteger = std::integral<T> and not std::same_as<T, bool> and not std::same_as<T, char>
+                                   and not std::same_as<T, wchar_t> and not std::same_as<T, char8_t>
+                                   and not std::same_as<T, char16_t> and not std::same_as<T, char32_t>;
+    }// namespace detail
+
+    /// Customization point for converting a command line value into a value of type T. Specialize this
+    /// template for your own types. The primary template falls back to the type's operator>>.
+    template<typename T>
+    struct converter {
+        [[nodiscard]] static bool convert(const std::string_view input, T& target) {
+            std::stringstream stream;
+            stream << input;
+            auto result = T{};
+            stream >> result;
+            if (stream.fail()) {
+                return false;
+            }
+            target = std::move(result);
+            return true;
+        }
+    };
+
+    template<detail::FromCharsInteger T>
+    struct converter<T> {
+        [[nodiscard]] static bool convert(std::string_view input, T& target) {
+            if (input.starts_with('+') and not input.starts_with("+-")) {
+                input.remove_prefix(1);
+            }
+            const auto end = input.data() + input.size();
+            const auto [pointer, error] = std::from_chars(input.data(), end, target);
+            return error == std::errc{} and pointer == end;
+        }
+    };
+
+    template<std::floating_point T>
+    struct converter<T> {
+        [[nodiscard]] static bool convert(std::string_view input, T& target) {
+            if (input.starts_with('+') and not input.starts_with("+-")) {
+                input.remove_prefix(1);
+            }
+            const auto end = input.data() + input.size();
+            const auto [pointer, error] = std::from_chars(input.data(), end, target);
+            return error == std::errc{} and pointer == end;
+        }
+    };
+
+    template<>
+    struct converter<bool> {
+        [[nodiscard]] static bool convert(const std::string_view input, bool& target) {
+            using namespace std::string_view_literals;
+            if (input == "1"sv or input == "true"sv) {
+                target = true;
+                return true;
+            }
+            if (input == "0"sv or input == "false"sv) {
+                target = false;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    template<>
+    struct converter<std::string> {
+        [[nodiscard]] static bool convert(const std::string_view input, std::string& target) {
+            target.assign(input);
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::pmr::string> {
+        [[nodiscard]] static bool convert(const std::string_view input, std::pmr::string& target) {
+            target.assign(input);
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::string_view> {
+        [[nodiscard]] static bool convert(const std::string_view input, std::string_view& target) {
+            target = input;
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::span<const char>> {
+        [[nodiscard]] static bool convert(const std::string_view input, std::span<const char>& target) {
+            target = std::span{ input.data(), input.size() };
+            return true;
+        }
+    };
+
     namespace detail {
 
         using ParseResult = std::variant<
@@ -48,11 +203,43 @@ namespace arguably {
                 result::CannotParseAgain,
                 result::ExcessUnnamedArguments,
                 result::CannotSetValueOfFlag,
-                result::ArgumentTypeMismatch>;
+                result::ArgumentTypeMismatch,
+                result::CannotOpenResponseFile,
+                result::UnterminatedQuote,
+                result::CompletionWritten,
+                result::CannotOpenConfigFile,
+                result::InvalidConfigLine>;
 
         using usize = std::size_t;
         using u8 = std::uint8_t;
 
+        /// copies a parse result, the strings of the copy are allocated with the given allocator
+        [[nodiscard]] inline ParseResult
+        copy_parse_result(const ParseResult& parse_result, const std::pmr::polymorphic_allocator<>& allocator) {
+            return std::visit(
+                    [&]<typename T>(const T& alternative) -> ParseResult {
+                        if constexpr (std::same_as<T, result::UnknownOption>) {
+                            if (const auto name = std::get_if<std::pmr::string>(&alternative.option)) {
+                                return T{ std::pmr::string{ *name, allocator } };
+                            }
+                            return alternative;
+                        } else if constexpr (std::same_as<T, result::CannotSetValueOfFlag>) {
+                            return T{ std::pmr::string{ alternative.option, allocator } };
+                        } else if constexpr (std::same_as<T, result::CannotOpenResponseFile>
+                                             or std::same_as<T, result::CannotOpenConfigFile>) {
+                            return T{ std::pmr::string{ alternative.path, allocator } };
+                        } else {
+                            return alternative;
+                        }
+                    },
+                    parse_result
+            );
+        }
+
+        /// value types that point into the command line instead of holding a copy
+        template<typename T>
+        inline constexpr bool is_view_v = std::same_as<T, std::string_view> or std::same_as<T, std::span<const char>>;
+
         template<usize Length>
         struct String final {
             constexpr String(const char (&value)[Length]) {
@@ -66,58 +253,186 @@ namespace arguably {
             std::array<char, Length> value;
         };
 
-        template<char Abbreviation, String Name, String Description>
+        /// Environment is the name of the environment variable the value is taken from if the argument is not
+        /// given on the command line (empty if there is none)
+        template<char Abbreviation, String Name, String Description, String Environment = "">
         struct Flag final {
             using ValueType = bool;
 
             constexpr static char abbreviation{ Abbreviation };
             constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
             constexpr static std::string_view description{ static_cast<std::string_view>(Description) };
+            constexpr static std::string_view environment_variable{ static_cast<std::string_view>(Environment) };
         };
 
-        template<char Abbreviation, String Name, String Description, typename Type>
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment = "">
         struct OptionallyNamedParameter final {
             using ValueType = Type;
 
             constexpr static char abbreviation{ Abbreviation };
             constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
             constexpr static std::string_view description{ static_cast<std::string_view>(Description) };
+            constexpr static std::string_view environment_variable{ static_cast<std::string_view>(Environment) };
         };
 
-        template<char Abbreviation, String Name, String Description, typename Type>
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment = "">
         struct NamedParameter final {
             using ValueType = Type;
 
             constexpr static char abbreviation{ Abbreviation };
             constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
             constexpr static std::string_view description{ static_cast<std::string_view>(Description) };
+            constexpr static std::string_view environment_variable{ static_cast<std::string_view>(Environment) };
         };
 
-        template<typename First, typename... Rest>
-        [[nodiscard]] constexpr usize max_name_length() {
-            constexpr usize first_length = First::name.length();
-            if constexpr (sizeof...(Rest) == 0) {
-                return first_length;
-            } else {
-                constexpr usize max_rest_length = max_name_length<Rest...>();
-                if constexpr (first_length > max_rest_length) {
-                    return first_length;
-                } else {
-                    return max_rest_length;
-                }
+        /// a named parameter that can be given multiple times, all values are collected in a vector
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment = "">
+        struct MultiParameter final {
+            using ValueType = std::pmr::vector<Type>;
+            using ElementType = Type;
+
+            constexpr static char abbreviation{ Abbreviation };
+            constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
+            constexpr static std::string_view description{ static_cast<std::string_view>(Description) };
+            constexpr static std::string_view environment_variable{ static_cast<std::string_view>(Environment) };
+        };
+
+        /// captures all remaining unnamed arguments (after the optionally named parameters got their values)
+        template<char Abbreviation, String Name, String Description>
+        struct RestParameter final {
+            using ValueType = std::span<const char* const>;
+
+            constexpr static char abbreviation{ Abbreviation };
+            constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
+            constexpr static std::string_view description{ static_cast<std::string_view>(Description) };
+            constexpr static std::string_view environment_variable{};
+        };
+
+        /// binds the argument with the given abbreviation to an environment variable, all others stay the same
+        template<typename Argument, char Abbreviation, String Variable>
+        struct BindEnvironment {
+            using type = Argument;
+        };
+
+        template<char Abbreviation, String Name, String Description, String Environment, String Variable>
+        struct BindEnvironment<Flag<Abbreviation, Name, Description, Environment>, Abbreviation, Variable> {
+            using type = Flag<Abbreviation, Name, Description, Variable>;
+        };
+
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment,
+                 String Variable>
+        struct BindEnvironment<
+                OptionallyNamedParameter<Abbreviation, Name, Description, Type, Environment>, Abbreviation, Variable> {
+            using type = OptionallyNamedParameter<Abbreviation, Name, Description, Type, Variable>;
+        };
+
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment,
+                 String Variable>
+        struct BindEnvironment<
+                NamedParameter<Abbreviation, Name, Description, Type, Environment>, Abbreviation, Variable> {
+            using type = NamedParameter<Abbreviation, Name, Description, Type, Variable>;
+        };
+
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment,
+                 String Variable>
+        struct BindEnvironment<
+                MultiParameter<Abbreviation, Name, Description, Type, Environment>, Abbreviation, Variable> {
+            using type = MultiParameter<Abbreviation, Name, Description, Type, Variable>;
+        };
+
+        template<typename Argument, char Abbreviation, String Variable>
+        using bind_environment_t = typename BindEnvironment<Argument, Abbreviation, Variable>::type;
+
+        template<typename... Arguments>
+        [[nodiscard]] consteval usize max_name_length() {
+            return std::max({ usize{ 0 }, Arguments::name.length()... });
+        }
+
+        template<String Text, typename... Arguments>
+        [[nodiscard]] consteval usize help_text_length() {
+            constexpr auto text = static_cast<std::string_view>(Text);
+            [[maybe_unused]] constexpr auto name_width = max_name_length<Arguments...>();
+            // "-a, --name  description\n" with the names padded to the same width
+            return (text.empty() ? 0 : text.length() + 1)
+                   + ((9 + name_width + Arguments::description.length()) + ... + 0);
+        }
+
+        /// the text (if any) followed by one line per argument
+        template<String Text, typename... Arguments>
+        [[nodiscard]] consteval auto make_help_text() {
+            auto result = std::array<char, help_text_length<Text, Arguments...>()>{};
+            auto position = result.begin();
+            const auto append = [&](const std::string_view part) {
+                position = std::copy(part.begin(), part.end(), position);
+            };
+            [[maybe_unused]] const auto append_line = [&](const char abbreviation, const std::string_view name,
+                                                          const std::string_view description) {
+                append("-");
+                *position++ = abbreviation;
+                append(", --");
+                append(name);
+                position = std::fill_n(position, max_name_length<Arguments...>() - name.length(), ' ');
+                append("  ");
+                append(description);
+                append("\n");
+            };
+
+            const auto text = static_cast<std::string_view>(Text);
+            if (not text.empty()) {
+                append(text);
+                append("\n");
             }
+            (append_line(Arguments::abbreviation, Arguments::name, Arguments::description), ...);
+            return result;
+        }
+
+        inline void write_text(std::FILE* const file, const std::string_view text) {
+            std::fwrite(text.data(), 1, text.size(), file);
+        }
+
+        inline void write_text(std::ostream& stream, const std::string_view text) {
+            stream.write(text.data(), static_cast<std::streamsize>(text.size()));
         }
 
-        template<typename Argument, typename... Rest>
-        constexpr void check_duplicate() {
-            if constexpr (sizeof...(Rest) != 0) {
-                static_assert(
-                        ((Argument::abbreviation != Rest::abbreviation) and ...),
-                        "duplicate argument abbreviations are not allowed"
-                );
-                static_assert(((Argument::name != Rest::name) and ...), "duplicate argument names are not allowed");
-                check_duplicate<Rest...>();
+        template<typename... Arguments>
+        [[nodiscard]] consteval bool has_unique_abbreviations() {
+            auto seen = std::array<bool, 256>{};
+            for (const auto abbreviation : { Arguments::abbreviation... }) {
+                if (seen[static_cast<u8>(abbreviation)]) {
+                    return false;
+                }
+                seen[static_cast<u8>(abbreviation)] = true;
             }
+            return true;
+        }
+
+        template<typename... Arguments>
+        [[nodiscard]] consteval bool has_unique_names() {
+            auto names = std::array<std::string_view, sizeof...(Arguments)>{ Arguments::name... };
+            std::sort(names.begin(), names.end());
+            return std::adjacent_find(names.begin(), names.end()) == names.end();
+        }
+
+        template<typename... Arguments>
+        [[nodiscard]] consteval bool has_unique_environment_variables() {
+            auto variables = std::array<std::string_view, sizeof...(Arguments)>{ Arguments::environment_variable... };
+            std::sort(variables.begin(), variables.end());
+            const auto first_bound = std::find_if(variables.begin(), variables.end(), [](const auto variable) {
+                return not variable.empty();
+            });
+            return std::adjacent_find(first_bound, variables.end()) == variables.end();
+        }
+
+        /// checks all arguments at once (instead of checking every new argument against all previous ones) so
+        /// that the cost of the check grows linearly with the number of arguments
+        template<typename... Arguments>
+        constexpr void check_duplicates() {
+            static_assert(has_unique_abbreviations<Arguments...>(), "duplicate argument abbreviations are not allowed");
+            static_assert(has_unique_names<Arguments...>(), "duplicate argument names are not allowed");
+            static_assert(
+                    has_unique_environment_variables<Arguments...>(),
+                    "an environment variable can only be bound to one argument"
+            );
         }
 
         template<char Abbreviation, detail::String Name>
@@ -128,8 +443,8 @@ namespace arguably {
             static_assert(static_cast<std::string_view>(Name) != "help"sv, R"("help" is a reserved argument name)");
         }
 
-        template<char Abbreviation, String Name, String Description>
-        [[nodiscard]] constexpr bool is_flag(Flag<Abbreviation, Name, Description>) {
+        template<char Abbreviation, String Name, String Description, String Environment>
+        [[nodiscard]] constexpr bool is_flag(Flag<Abbreviation, Name, Description, Environment>) {
             return true;
         }
 
@@ -138,8 +453,9 @@ namespace arguably {
             return false;
         }
 
-        template<char Abbreviation, String Name, String Description, typename Type>
-        [[nodiscard]] constexpr bool is_named_parameter(NamedParameter<Abbreviation, Name, Description, Type>) {
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment>
+        [[nodiscard]] constexpr bool
+        is_named_parameter(NamedParameter<Abbreviation, Name, Description, Type, Environment>) {
             return true;
         }
 
@@ -148,9 +464,9 @@ namespace arguably {
             return false;
         }
 
-        template<char Abbreviation, String Name, String Description, typename Type>
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment>
         [[nodiscard]] constexpr bool
-        is_optionally_named_parameter(OptionallyNamedParameter<Abbreviation, Name, Description, Type>) {
+        is_optionally_named_parameter(OptionallyNamedParameter<Abbreviation, Name, Description, Type, Environment>) {
             return true;
         }
 
@@ -159,6 +475,27 @@ namespace arguably {
             return false;
         }
 
+        template<char Abbreviation, String Name, String Description, typename Type, String Environment>
+        [[nodiscard]] constexpr bool
+        is_multi_parameter(MultiParameter<Abbreviation, Name, Description, Type, Environment>) {
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]] constexpr bool is_multi_parameter(T) {
+            return false;
+        }
+
+        template<char Abbreviation, String Name, String Description>
+        [[nodiscard]] constexpr bool is_rest_parameter(RestParameter<Abbreviation, Name, Description>) {
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]] constexpr bool is_rest_parameter(T) {
+            return false;
+        }
+
         template<typename... Arguments>
         consteval usize count_flags() {
             if constexpr (sizeof...(Arguments) == 0) {
@@ -186,345 +523,1739 @@ namespace arguably {
             }
         }
 
-        template<char Abbreviation, typename First, typename... Rest>
-        [[nodiscard]] consteval bool has_abbreviation_impl() {
-            if constexpr (First::abbreviation == Abbreviation) {
-                return true;
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return has_abbreviation_impl<Abbreviation, Rest...>();
-            } else {
-                return false;
-            }
-        }
-
-        template<typename First, typename... Rest>
-        [[nodiscard]] constexpr std::optional<char> get_abbreviation_of_name_impl(const std::string_view name) {
-            if (First::name == name) {
-                return First::abbreviation;
-            }
-            if constexpr (sizeof...(Rest) > 0) {
-                return get_abbreviation_of_name_impl<Rest...>(name);
-            } else {
-                return {};
-            }
-        }
-
         template<typename... Arguments>
-        [[nodiscard]] constexpr bool is_flag_impl([[maybe_unused]] const char abbreviation) {
+        consteval usize count_multi_parameters() {
             if constexpr (sizeof...(Arguments) == 0) {
-                return false;
+                return 0;
             } else {
-                return ((is_flag(Arguments{}) and Arguments::abbreviation == abbreviation) or ...);
+                return static_cast<usize>((is_multi_parameter(Arguments{}) + ...));
             }
         }
 
         template<typename... Arguments>
-        [[nodiscard]] constexpr bool is_named_parameter_impl([[maybe_unused]] const char abbreviation) {
+        consteval usize count_rest_parameters() {
             if constexpr (sizeof...(Arguments) == 0) {
-                return false;
+                return 0;
             } else {
-                return ((is_named_parameter(Arguments{}) and Arguments::abbreviation == abbreviation) or ...);
+                return static_cast<usize>((is_rest_parameter(Arguments{}) + ...));
             }
         }
 
-        template<typename... Arguments>
-        [[nodiscard]] constexpr bool is_optionally_named_parameter_impl([[maybe_unused]] const char abbreviation) {
-            if constexpr (sizeof...(Arguments) == 0) {
-                return false;
-            } else {
-                return ((is_optionally_named_parameter(Arguments{}) and Arguments::abbreviation == abbreviation) or ...
-                );
-            }
+        template<char Abbreviation, typename... Arguments>
+        [[nodiscard]] consteval bool has_abbreviation_impl() {
+            return ((Arguments::abbreviation == Abbreviation) or ...);
         }
 
-        template<char Abbreviation, usize Offset, typename Argument, typename... Rest>
-        [[nodiscard]] consteval usize index_of_impl() {
-            static_assert(has_abbreviation_impl<Abbreviation, Argument, Rest...>(), "unknown abbreviation");
-            if constexpr (Argument::abbreviation == Abbreviation) {
-                return Offset;
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return index_of_impl<Abbreviation, Offset + 1, Rest...>();
-            } else {
-                throw;
-            }
+        template<char Abbreviation, typename... Arguments>
+        [[nodiscard]] consteval usize index_of_abbreviation() {
+            static_assert(has_abbreviation_impl<Abbreviation, Arguments...>(), "unknown abbreviation");
+            constexpr auto abbreviations = std::array<char, sizeof...(Arguments)>{ Arguments::abbreviation... };
+            return static_cast<usize>(std::find(abbreviations.begin(), abbreviations.end(), Abbreviation)
+                                      - abbreviations.begin());
         }
 
-        template<usize Offset, typename Argument, typename... Rest>
-        [[nodiscard]] constexpr usize index_of_impl(const char abbreviation) {
-            if (Argument::abbreviation == abbreviation) {
-                return Offset;
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return index_of_impl<Offset + 1, Rest...>(abbreviation);
-            } else {
-                throw;
+        /// FNV-1a
+        [[nodiscard]] constexpr std::uint64_t hash_name(const std::string_view name) {
+            auto hash = std::uint64_t{ 14695981039346656037ULL };
+            for (const auto c : name) {
+                hash ^= static_cast<u8>(c);
+                hash *= std::uint64_t{ 1099511628211ULL };
             }
+            return hash;
         }
 
-        struct AnyVector : public std::vector<std::any> { };
-
-        template<usize Offset, typename Argument, typename... Rest>
-        void print_default_values_impl(const AnyVector& default_values) {
-            if constexpr (sizeof...(Rest) > 0) {
-                print_default_values_impl<Offset + 1, Rest...>(default_values);
-            }
+        [[nodiscard]] constexpr std::uint64_t rehash(std::uint64_t hash, const std::uint64_t seed) {
+            hash ^= seed * std::uint64_t{ 0x9E3779B97F4A7C15ULL };
+            hash ^= hash >> 31;
+            hash *= std::uint64_t{ 0xBF58476D1CE4E5B9ULL };
+            hash ^= hash >> 29;
+            return hash;
         }
 
-        template<usize Offset, typename Argument, typename... Rest>
-        auto get_value(const AnyVector& values, const char abbreviation) {
-            if (Argument::abbreviation == abbreviation) {
-                return std::any_cast<typename Argument::ValueType>(values[Offset]);
-            }
-            if constexpr (sizeof...(Rest) > 0) {
-                return get_value<Offset + 1, Rest...>(values, abbreviation);
-            } else {
-                throw;
-            }
-        }
+        /// Perfect hash table over a fixed set of names (hash and displace). The bucket of a name selects a
+        /// seed which moves all names of that bucket into distinct slots. A lookup costs one hash of the
+        /// key and one string comparison.
+        template<usize NumNames>
+        struct PerfectHashTable final {
+            static constexpr usize num_slots = std::bit_ceil(std::max(NumNames, usize{ 1 }) * 2);
+            static constexpr usize empty_slot = NumNames;
 
-        template<char Abbreviation, usize Offset, typename Argument, typename... Rest>
-        auto get_value([[maybe_unused]] const AnyVector& values) {
-            if constexpr (Argument::abbreviation == Abbreviation) {
-                return std::any_cast<typename Argument::ValueType>(values[Offset]);
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return get_value<Abbreviation, Offset + 1, Rest...>(values);
-            } else {
-                throw;
-            }
-        }
+            std::array<std::string_view, NumNames> names{};
+            std::array<std::uint64_t, num_slots> seeds{};
+            std::array<usize, num_slots> slots{};
 
-        template<usize Offset, typename Argument, typename... Rest, typename Value>
-        [[nodiscard]] bool store_at_impl(AnyVector& values, const usize index, Value&& value) {
-            if (index == Offset) {
-                std::stringstream stream;
-                stream << std::forward<Value>(value);
-                auto result = typename Argument::ValueType{};
-                stream >> result;
-                if (stream.fail()) {
-                    return false;
-                }
-                values[index] = result;
-                return true;
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return store_at_impl<Offset + 1, Rest...>(values, index, std::forward<Value>(value));
-            } else {
-                throw;
+            [[nodiscard]] static constexpr usize bucket_of(const std::uint64_t hash) {
+                return static_cast<usize>(hash & (num_slots - 1));
             }
-        }
-
-        struct ArgumentsView {
-            usize argument_index{ 1 };
-            usize char_offset{ 0 };
-            usize argc;
-            const char** argv;
 
-            [[nodiscard]] char current() const {
-                const auto at_current = argv[argument_index][char_offset];
-                return at_current == '\0' ? ' ' : at_current;
+            [[nodiscard]] static constexpr usize slot_of(const std::uint64_t hash, const std::uint64_t seed) {
+                return static_cast<usize>(rehash(hash, seed) & (num_slots - 1));
             }
 
-            [[nodiscard]] char consume() {
-                const auto result = current();
-                advance();
-                return result;
+            [[nodiscard]] constexpr std::optional<usize> find(const std::string_view key) const {
+                const auto hash = hash_name(key);
+                const auto index = slots[slot_of(hash, seeds[bucket_of(hash)])];
+                if (index == empty_slot or names[index] != key) {
+                    return {};
+                }
+                return index;
             }
+        };
 
-            [[nodiscard]] char peek() const {
-                assert(not eof());
-                const auto [new_argument_index, new_char_offset] = *next_position();
-                const auto next_char = argv[new_argument_index][new_char_offset];
-                return next_char == '\0' ? ' ' : next_char;
+        template<usize NumNames>
+        [[nodiscard]] consteval PerfectHashTable<NumNames> make_perfect_hash_table(
+                const std::array<std::string_view, NumNames>& names
+        ) {
+            using Table = PerfectHashTable<NumNames>;
+            constexpr usize max_seed = 1'000'000;
+
+            auto table = Table{};
+            table.names = names;
+            table.slots.fill(Table::empty_slot);
+
+            auto hashes = std::array<std::uint64_t, NumNames>{};
+            auto bucket_sizes = std::array<usize, Table::num_slots>{};
+            for (usize i = 0; i < NumNames; ++i) {
+                hashes[i] = hash_name(names[i]);
+                ++bucket_sizes[Table::bucket_of(hashes[i])];
             }
 
-            void next_arg() {
-                ++argument_index;
-                char_offset = 0;
+            // place the largest buckets first since they are the hardest to fit
+            auto bucket_order = std::array<usize, Table::num_slots>{};
+            for (usize i = 0; i < Table::num_slots; ++i) {
+                bucket_order[i] = i;
             }
-
-            [[nodiscard]] std::optional<std::pair<usize, usize>> next_position() const {
-                if (argument_index >= argc) {
-                    return {};
+            std::sort(bucket_order.begin(), bucket_order.end(), [&](const usize lhs, const usize rhs) {
+                return bucket_sizes[lhs] > bucket_sizes[rhs];
+            });
+
+            auto members = std::array<usize, NumNames>{};
+            auto member_slots = std::array<usize, NumNames>{};
+            for (const auto bucket : bucket_order) {
+                if (bucket_sizes[bucket] == 0) {
+                    break;
                 }
-                if (argv[argument_index][char_offset] == '\0') {
-                    if (argument_index >= argc - 1) {
-                        return {};
+                usize num_members = 0;
+                for (usize i = 0; i < NumNames; ++i) {
+                    if (Table::bucket_of(hashes[i]) == bucket) {
+                        members[num_members++] = i;
                     }
-                    return {
-                        std::pair{argument_index + 1, 0}
-                    };
                 }
-                return {
-                    std::pair{argument_index, char_offset + 1}
-                };
-            }
 
-            void advance() {
-                if (eof()) {
-                    return;
+                auto seed = std::uint64_t{ 0 };
+                for (; seed < max_seed; ++seed) {
+                    auto fits = true;
+                    for (usize i = 0; i < num_members and fits; ++i) {
+                        member_slots[i] = Table::slot_of(hashes[members[i]], seed);
+                        fits = (table.slots[member_slots[i]] == Table::empty_slot);
+                        for (usize j = 0; j < i and fits; ++j) {
+                            fits = (member_slots[i] != member_slots[j]);
+                        }
+                    }
+                    if (fits) {
+                        break;
+                    }
+                }
+                if (seed == max_seed) {
+                    throw std::logic_error{ "unable to find a perfect hash function for the argument names" };
+                }
+                table.seeds[bucket] = seed;
+                for (usize i = 0; i < num_members; ++i) {
+                    table.slots[member_slots[i]] = members[i];
                 }
-
-                const auto [new_argument_index, new_char_offset] = *next_position();
-                argument_index = new_argument_index;
-                char_offset = new_char_offset;
             }
+            return table;
+        }
 
-            [[nodiscard]] std::string_view arg_tail() const {
-                return std::string_view{ argv[argument_index] }.substr(char_offset);
-            }
+        /// A cheap check in front of a lookup in a PerfectHashTable. Most keys that are not in the table differ from
+        /// all names in their length or their last character, so they can be rejected without hashing them.
+        struct NameFilter final {
+            std::uint64_t lengths{ 0 };
+            std::array<std::uint64_t, 4> last_characters{};
 
-            [[nodiscard]] std::string_view consume_arg() {
-                const auto result = arg_tail();
-                ++argument_index;
-                char_offset = 0;
-                return result;
+            [[nodiscard]] static constexpr usize length_bit(const usize length) {
+                return std::min(length, usize{ 63 });
             }
 
-            [[nodiscard]] bool eof() const {
-                return not next_position().has_value();
+            [[nodiscard]] constexpr bool may_contain(const std::string_view key) const {
+                if (key.empty()) {
+                    return false;
+                }
+                const auto last = static_cast<u8>(key.back());
+                return (lengths >> length_bit(key.length()) & 1) != 0
+                       and (last_characters[last / 64] >> (last % 64) & 1) != 0;
             }
         };
 
-        template<usize Offset, typename First, typename... Rest, usize NumArgs>
-        [[nodiscard]] std::optional<char> abbreviation_of_first_unseen_optionally_named(
-                const std::array<bool, NumArgs>& found_args
-        ) {
-            if (not found_args[Offset] and is_optionally_named_parameter(First{})) {
-                return First::abbreviation;
-            }
-            if constexpr (sizeof...(Rest) > 0) {
-                return abbreviation_of_first_unseen_optionally_named<Offset + 1, Rest...>(found_args);
-            } else {
-                return {};
-            }
-        }
-
-    }// namespace detail
-
-    template<detail::String InfoText, detail::String HelpText, typename... Arguments>
-    class Parser final {
-    private:
-        using ArgumentsMap = std::unordered_map<char, std::string>;
-
-    private:
-        constexpr explicit Parser(detail::AnyVector&& default_values) : m_values{ std::move(default_values) } { }
-
-        template<typename First, typename... Rest>
-        constexpr void print_help(auto&& stream, detail::usize max_name_width) const {
-            fmt::print(
-                    stream, "-{}, --{:{}}  {}\n", First::abbreviation, First::name, max_name_width, First::description
-            );
-            if constexpr (sizeof...(Rest) > 0) {
-                print_help<Rest...>(stream, max_name_width);
+        template<usize NumNames>
+        [[nodiscard]] consteval NameFilter make_name_filter(const std::array<std::string_view, NumNames>& names) {
+            auto filter = NameFilter{};
+            for (const auto name : names) {
+                const auto last = static_cast<u8>(name.back());
+                filter.lengths |= std::uint64_t{ 1 } << NameFilter::length_bit(name.length());
+                filter.last_characters[last / 64] |= std::uint64_t{ 1 } << (last % 64);
             }
+            return filter;
         }
 
-        template<typename First, typename... Rest>
-        [[nodiscard]] static constexpr std::string_view get_name(const char abbreviation) {
-            if (First::abbreviation == abbreviation) {
-                return First::name;
-            }
-            if constexpr (sizeof...(Rest) > 0) {
-                return get_name<Rest...>(abbreviation);
-            }
-            return "";
-        }
+        enum class ArgumentKind : u8 {
+            None,
+            Flag,
+            NamedParameter,
+            OptionallyNamedParameter,
+            MultiParameter,
+            RestParameter,
+        };
 
-        template<char Abbreviation, typename First, typename... Rest>
-        [[nodiscard]] consteval std::string_view get_name() {
-            if constexpr (First::abbreviation == Abbreviation) {
-                return First::name;
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return get_name<Abbreviation, Rest...>();
+        template<typename Argument>
+        [[nodiscard]] consteval ArgumentKind kind_of() {
+            if constexpr (is_flag(Argument{})) {
+                return ArgumentKind::Flag;
+            } else if constexpr (is_named_parameter(Argument{})) {
+                return ArgumentKind::NamedParameter;
+            } else if constexpr (is_multi_parameter(Argument{})) {
+                return ArgumentKind::MultiParameter;
+            } else if constexpr (is_rest_parameter(Argument{})) {
+                return ArgumentKind::RestParameter;
             } else {
-                throw;
+                static_assert(is_optionally_named_parameter(Argument{}), "unknown argument kind");
+                return ArgumentKind::OptionallyNamedParameter;
             }
         }
 
-    public:
-        operator bool() const {
-            return std::holds_alternative<result::Okay>(m_parse_result);
-        }
+        /// values of types whose converter declares "static constexpr bool lazy = true" are converted on first access
+        template<typename T>
+        inline constexpr bool has_lazy_converter_v = requires { requires converter<T>::lazy; };
 
-        [[nodiscard]] detail::ParseResult result() const {
-            return m_parse_result;
+        template<typename Argument>
+        [[nodiscard]] consteval bool is_lazy() {
+            constexpr auto kind = kind_of<Argument>();
+            return (kind == ArgumentKind::NamedParameter or kind == ArgumentKind::OptionallyNamedParameter)
+                   and has_lazy_converter_v<typename Argument::ValueType>;
         }
 
         template<typename T>
-        [[nodiscard]] bool result_is() const {
-            return std::holds_alternative<T>(m_parse_result);
-        }
+        inline constexpr bool is_string_v = false;
 
-        template<char Abbreviation>
-        [[nodiscard]] static consteval bool has_abbreviation() {
-            return detail::has_abbreviation_impl<Abbreviation, Arguments...>();
-        }
+        template<typename Traits, typename Allocator>
+        inline constexpr bool is_string_v<std::basic_string<char, Traits, Allocator>> = true;
 
-        [[nodiscard]] std::optional<char> get_abbreviation_of_name(const std::string_view name) {
-            return detail::get_abbreviation_of_name_impl<Arguments...>(name);
+        /// whether storing a value copies its text into a string (other types are converted, views point to the text)
+        template<typename Argument>
+        [[nodiscard]] consteval bool copies_text() {
+            if constexpr (is_multi_parameter(Argument{})) {
+                return is_string_v<typename Argument::ElementType>;
+            } else {
+                return is_string_v<typename Argument::ValueType>;
+            }
         }
 
-        [[nodiscard]] static constexpr bool is_flag(const char abbreviation) {
-            return detail::is_flag_impl<Arguments...>(abbreviation);
-        }
+        /// collects text at compile time, it is written twice: first to measure it and then into an array
+        template<usize Capacity>
+        struct TextBuffer final {
+            std::array<char, Capacity> text{};
+            usize size{ 0 };
 
-        [[nodiscard]] static constexpr bool is_named_parameter(const char abbreviation) {
-            return detail::is_named_parameter_impl<Arguments...>(abbreviation);
+            constexpr void append(const char c) {
+                if (size < Capacity) {
+                    text[size] = c;
+                }
+                ++size;
+            }
+
+            constexpr void append(const std::string_view part) {
+                for (const auto c : part) {
+                    append(c);
+                }
+            }
+        };
+
+        template<typename Writer>
+        [[nodiscard]] consteval auto make_text() {
+            constexpr auto length = [] {
+                auto buffer = TextBuffer<0>{};
+                Writer::write(buffer);
+                return buffer.size;
+            }();
+            auto buffer = TextBuffer<length>{};
+            Writer::write(buffer);
+            return buffer.text;
         }
 
-        [[nodiscard]] static constexpr bool is_optionally_named_parameter(const char abbreviation) {
-            return detail::is_optionally_named_parameter_impl<Arguments...>(abbreviation);
+        /// only these abbreviations are offered by the completion scripts and by Schema::complete()
+        [[nodiscard]] constexpr bool is_alphanumeric(const char c) {
+            return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or (c >= '0' and c <= '9');
+        }
+
+        /// the options as arguments of zsh's _arguments, one per line
+        template<typename... Arguments>
+        struct ZshCompletion final {
+            static constexpr void write(auto& out) {
+                (write_argument<Arguments>(out), ...);
+            }
+
+            template<typename Argument>
+            static constexpr void write_argument(auto& out) {
+                constexpr auto kind = kind_of<Argument>();
+                if constexpr (kind != ArgumentKind::RestParameter) {
+                    constexpr auto takes_value = (kind != ArgumentKind::Flag);
+                    constexpr auto has_abbreviation = is_alphanumeric(Argument::abbreviation);
+                    out.append("        ");
+                    if (kind == ArgumentKind::MultiParameter) {
+                        out.append("'*'");
+                    } else if (has_abbreviation) {
+                        out.append("'(-");
+                        out.append(Argument::abbreviation);
+                        out.append(" --");
+                        out.append(Argument::name);
+                        out.append(")'");
+                    } else {
+                        out.append("'(--");
+                        out.append(Argument::name);
+                        out.append(")'");
+                    }
+                    if (has_abbreviation) {
+                        out.append("{-");
+                        out.append(Argument::abbreviation);
+                        out.append(takes_value ? "+,--" : ",--");
+                        out.append(Argument::name);
+                        out.append(takes_value ? "=}" : "}");
+                    } else {
+                        out.append("--");
+                        out.append(Argument::name);
+                        out.append(takes_value ? "=" : "");
+                    }
+                    out.append("'[");
+                    for (const auto c : Argument::description) {
+                        if (c == '\'') {
+                            out.append("'\\''");
+                        } else {
+                            if (c == '\\' or c == ']' or c == ':') {
+                                out.append('\\');
+                            }
+                            out.append(c);
+                        }
+                    }
+                    out.append("]");
+                    if (takes_value) {
+                        out.append(":");
+                        out.append(Argument::name);
+                        out.append(":_files");
+                    }
+                    out.append("' \\\n");
+                }
+            }
+        };
+
+        /// one "complete" command per option, the program name is taken from the variable $program
+        template<typename... Arguments>
+        struct FishCompletion final {
+            static constexpr void write(auto& out) {
+                (write_argument<Arguments>(out), ...);
+            }
+
+            template<typename Argument>
+            static constexpr void write_argument(auto& out) {
+                constexpr auto kind = kind_of<Argument>();
+                if constexpr (kind != ArgumentKind::RestParameter) {
+                    out.append("complete -c $program");
+                    if (is_alphanumeric(Argument::abbreviation)) {
+                        out.append(" -s ");
+                        out.append(Argument::abbreviation);
+                    }
+                    out.append(" -l ");
+                    out.append(Argument::name);
+                    if (kind != ArgumentKind::Flag) {
+                        out.append(" -r");
+                    }
+                    if (not Argument::description.empty()) {
+                        out.append(" -d '");
+                        for (const auto c : Argument::description) {
+                            if (c == '\\' or c == '\'') {
+                                out.append('\\');
+                            }
+                            out.append(c);
+                        }
+                        out.append("'");
+                    }
+                    out.append("\n");
+                }
+            }
+        };
+
+        /// Collects output in a fixed buffer and writes it with as few calls as possible. Where possible, the
+        /// buffer is written to the file descriptor directly, so the stream does not allocate a buffer of its own.
+        class OutputBuffer final {
+        public:
+            explicit OutputBuffer(std::FILE* const file) : m_file{ file } { }
+
+            OutputBuffer(const OutputBuffer&) = delete;
+            OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+            ~OutputBuffer() {
+                flush();
+            }
+
+            void append(std::string_view text) {
+                while (not text.empty()) {
+                    if (m_size == m_buffer.size()) {
+                        flush();
+                    }
+                    const auto count = std::min(text.size(), m_buffer.size() - m_size);
+                    std::copy_n(text.begin(), count, m_buffer.begin() + static_cast<std::ptrdiff_t>(m_size));
+                    m_size += count;
+                    text.remove_prefix(count);
+                }
+            }
+
+            void append(const char c) {
+                append(std::string_view{ &c, 1 });
+            }
+
+            void flush() {
+                if (m_size == 0) {
+                    return;
+                }
+#ifdef ARGUABLY_USE_POSIX_WRITE
+                std::fflush(m_file);
+                const auto file_descriptor = ::fileno(m_file);
+                for (usize written = 0; written < m_size;) {
+                    const auto result = ::write(file_descriptor, m_buffer.data() + written, m_size - written);
+                    if (result <= 0) {
+                        break;
+                    }
+                    written += static_cast<usize>(result);
+                }
+#else
+                std::fwrite(m_buffer.data(), 1, m_size, m_file);
+#endif
+                m_size = 0;
+            }
+
+        private:
+            std::FILE* m_file;
+            std::array<char, 4096> m_buffer;
+            usize m_size{ 0 };
+        };
+
+        struct DispatchEntry final {
+            ArgumentKind kind{ ArgumentKind::None };
+            usize index{ 0 };
+        };
+
+        /// maps every possible abbreviation to the kind and index of the argument it belongs to
+        template<typename... Arguments>
+        [[nodiscard]] consteval std::array<DispatchEntry, 256> make_dispatch_table() {
+            auto table = std::array<DispatchEntry, 256>{};
+            usize index = 0;
+            ((table[static_cast<u8>(Arguments::abbreviation)] = DispatchEntry{ kind_of<Arguments>(), index++ }), ...);
+            return table;
+        }
+
+        template<typename... Arguments>
+        using ValueTuple = std::tuple<typename Arguments::ValueType...>;
+
+        /// The ParserBuilder collects the default values in a chain of nodes (one per argument) instead of a
+        /// tuple. Appending a value therefore only instantiates a single new node type, whereas appending to a
+        /// tuple would instantiate a complete new tuple for every argument.
+        struct EmptyDefaultValues final { };
+
+        template<typename Previous, typename Value>
+        struct DefaultValueNode final {
+            Previous previous;
+            Value value;
+        };
+
+        template<typename Values, typename... CollectedValues>
+        [[nodiscard]] Values flatten_default_values(EmptyDefaultValues&&, CollectedValues&&... collected_values) {
+            return Values{ std::move(collected_values)... };
+        }
+
+        template<typename Values, typename Previous, typename Value, typename... CollectedValues>
+        [[nodiscard]] Values flatten_default_values(
+                DefaultValueNode<Previous, Value>&& node,
+                CollectedValues&&... collected_values
+        ) {
+            return flatten_default_values<Values>(
+                    std::move(node.previous), std::move(node.value), std::move(collected_values)...
+            );
+        }
+
+        template<usize Index, typename Values, typename Argument>
+        [[nodiscard]] bool store_at(Values& values, const std::string_view value) {
+            if constexpr (is_multi_parameter(Argument{})) {
+                using T = typename Argument::ElementType;
+                auto& elements = std::get<Index>(values);
+                auto element = std::make_obj_using_allocator<T>(elements.get_allocator());
+                if (not converter<T>::convert(value, element)) {
+                    return false;
+                }
+                elements.push_back(std::move(element));
+                return true;
+            } else if constexpr (is_rest_parameter(Argument{})) {
+                return false;// the rest parameter is never set by its name
+            } else {
+                using T = std::tuple_element_t<Index, Values>;
+                return converter<T>::convert(value, std::get<Index>(values));
+            }
+        }
+
+        template<usize Index, typename Values>
+        void set_flag_at(Values& values) {
+            if constexpr (std::is_same_v<std::tuple_element_t<Index, Values>, bool>) {
+                std::get<Index>(values) = true;
+            }
+        }
+
+        template<usize Index, typename Values>
+        void restore_at(Values& values, const Values& default_values) {
+            std::get<Index>(values) = std::get<Index>(default_values);
+        }
+
+        template<usize Index, typename Values, typename Argument>
+        void reserve_at(Values& values, const usize additional_count) {
+            if constexpr (is_multi_parameter(Argument{})) {
+                auto& elements = std::get<Index>(values);
+                elements.reserve(elements.size() + additional_count);
+            }
+        }
+
+        template<typename Values, typename Indices, typename... Arguments>
+        struct ValueAccessors;
+
+        /// function tables to access the values by their runtime index
+        template<typename Values, usize... Indices, typename... Arguments>
+        struct ValueAccessors<Values, std::index_sequence<Indices...>, Arguments...> final {
+            static constexpr auto store = std::array<bool (*)(Values&, std::string_view), sizeof...(Indices)>{
+                &store_at<Indices, Values, Arguments>...
+            };
+            static constexpr auto set_flag = std::array<void (*)(Values&), sizeof...(Indices)>{
+                &set_flag_at<Indices, Values>...
+            };
+            static constexpr auto restore = std::array<void (*)(Values&, const Values&), sizeof...(Indices)>{
+                &restore_at<Indices, Values>...
+            };
+            static constexpr auto reserve = std::array<void (*)(Values&, usize), sizeof...(Indices)>{
+                &reserve_at<Indices, Values, Arguments>...
+            };
+        };
+
+        /// maps the positions whose flag is set to consecutive slots, all others to the number of slots
+        template<usize Size>
+        [[nodiscard]] constexpr std::array<usize, Size> make_slots(const std::array<bool, Size>& flags) {
+            const auto num_slots = static_cast<usize>(std::count(flags.begin(), flags.end(), true));
+            auto result = std::array<usize, Size>{};
+            usize next_slot = 0;
+            for (usize i = 0; i < Size; ++i) {
+                result[i] = flags[i] ? next_slot++ : num_slots;
+            }
+            return result;
+        }
+
+        [[nodiscard]] inline usize default_num_threads() {
+            return std::max(usize{ std::thread::hardware_concurrency() }, usize{ 1 });
+        }
+
+        /// Calls function(index) for every index in [0, count) on up to the given number of threads (including the
+        /// calling thread). Every thread gets at least min_items_per_thread indices, so small counts are processed on
+        /// the calling thread alone and do not pay for starting threads. The indices are handed out in chunks from a
+        /// shared counter, so threads that finish their chunks early take over the remaining work. The first exception
+        /// thrown by the function is rethrown after all threads have finished.
+        template<typename Function>
+        void parallel_for(const usize count, usize num_threads, Function&& function) {
+            constexpr usize chunk_size = 256;
+            constexpr usize min_items_per_thread = 4 * chunk_size;
+            num_threads = std::clamp(num_threads, usize{ 1 }, std::max(count / min_items_per_thread, usize{ 1 }));
+            if (num_threads == 1) {
+                for (usize i = 0; i < count; ++i) {
+                    function(i);
+                }
+                return;
+            }
+
+            auto next_chunk_begin = std::atomic<usize>{ 0 };
+            auto exception = std::exception_ptr{};
+            auto exception_mutex = std::mutex{};
+            const auto work = [&] {
+                try {
+                    while (true) {
+                        const auto begin = next_chunk_begin.fetch_add(chunk_size, std::memory_order_relaxed);
+                        if (begin >= count) {
+                            return;
+                        }
+                        const auto end = std::min(begin + chunk_size, count);
+                        for (auto i = begin; i < end; ++i) {
+                            function(i);
+                        }
+                    }
+                } catch (...) {
+                    next_chunk_begin.store(count, std::memory_order_relaxed);
+                    const auto lock = std::scoped_lock{ exception_mutex };
+                    if (not exception) {
+                        exception = std::current_exception();
+                    }
+                }
+            };
+
+            auto threads = std::vector<std::thread>{};
+            threads.reserve(num_threads - 1);
+            for (usize i = 1; i < num_threads; ++i) {
+                threads.emplace_back(work);
+            }
+            work();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        /// A copy of the input, split into lines. The lines are views into the copy, which stays in place when this
+        /// object is moved.
+        struct SplitLines final {
+            std::pmr::vector<char> buffer;
+            std::pmr::vector<std::string_view> lines;
+
+            SplitLines(const std::string_view input, const std::pmr::polymorphic_allocator<>& allocator)
+                : buffer(input.begin(), input.end(), allocator),
+                  lines{ allocator } {
+                auto rest = std::string_view{ buffer.data(), buffer.size() };
+                while (not rest.empty()) {
+                    const auto line_end = rest.find('\n');
+                    lines.push_back(rest.substr(0, line_end));
+                    rest.remove_prefix(line_end == std::string_view::npos ? rest.size() : line_end + 1);
+                }
+            }
+
+            [[nodiscard]] usize size() const {
+                return lines.size();
+            }
+        };
+
+        /// removes spaces, tabs and carriage returns from both ends
+        [[nodiscard]] constexpr std::string_view trim(const std::string_view text) {
+            constexpr auto whitespace = std::string_view{ " \t\r" };
+            const auto first = text.find_first_not_of(whitespace);
+            if (first == std::string_view::npos) {
+                return {};
+            }
+            return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+        }
+
+#ifdef ARGUABLY_USE_ENVIRON
+        /// the environment of the process as a null terminated array of "NAME=value" strings
+        [[nodiscard]] inline const char* const* environment_block() {
+#if defined(__APPLE__)
+            return *_NSGetEnviron();
+#else
+            return environ;
+#endif
+        }
+#endif
+
+        /// A read-only view of the contents of a whole file. Where supported, the file is mapped into memory
+        /// instead of being read.
+        class MappedFile final {
+        private:
+            struct Key final { };
+
+        public:
+            MappedFile(Key, [[maybe_unused]] const std::pmr::polymorphic_allocator<>& allocator)
+#ifndef ARGUABLY_USE_MMAP
+                : m_buffer{ allocator }
+#endif
+            {
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile() {
+#ifdef ARGUABLY_USE_MMAP
+                if (not m_contents.empty()) {
+                    ::munmap(const_cast<char*>(m_contents.data()), m_contents.size());
+                }
+#endif
+            }
+
+            /// returns nullptr if the file cannot be opened
+            [[nodiscard]] static std::shared_ptr<const MappedFile>
+            open(const char* const path, const std::pmr::polymorphic_allocator<>& allocator) {
+                auto file = std::allocate_shared<MappedFile>(allocator, Key{}, allocator);
+#ifdef ARGUABLY_USE_MMAP
+                const auto file_descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+                if (file_descriptor < 0) {
+                    return nullptr;
+                }
+                struct stat status { };
+                if (::fstat(file_descriptor, &status) != 0 or not S_ISREG(status.st_mode)) {
+                    ::close(file_descriptor);
+                    return nullptr;
+                }
+                const auto size = static_cast<usize>(status.st_size);
+                if (size > 0) {
+                    const auto address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                    if (address == MAP_FAILED) {
+                        ::close(file_descriptor);
+                        return nullptr;
+                    }
+                    ::madvise(address, size, MADV_SEQUENTIAL);
+                    file->m_contents = std::string_view{ static_cast<const char*>(address), size };
+                }
+                ::close(file_descriptor);
+#else
+                auto stream = std::ifstream{ path, std::ios::binary };
+                if (not stream) {
+                    return nullptr;
+                }
+                file->m_buffer.assign(std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{});
+                file->m_contents = file->m_buffer;
+#endif
+                return file;
+            }
+
+            [[nodiscard]] std::string_view contents() const {
+                return m_contents;
+            }
+
+        private:
+            std::string_view m_contents;
+#ifndef ARGUABLY_USE_MMAP
+            std::pmr::string m_buffer;
+#endif
+        };
+
+        /// Buffers that values of type std::string_view may point into (mapped response files and unquoted words).
+        using Storage = std::pmr::vector<std::shared_ptr<const void>>;
+
+        /// Walks the command line argument by argument and character by character. If enabled, arguments of the form
+        /// "@path" taken from argv are replaced by the words of the file at that path (see expand_response_file()).
+        /// The file is mapped into memory and the words are handed out as views into the mapping, one at a time.
+        /// A command line given as a single string and the contents of response files are split into words following
+        /// the quoting rules of a POSIX shell. Only words that contain quotes or backslashes are copied, all others
+        /// are views into the string or the mapping.
+        struct ArgumentsView {
+            static constexpr const char* no_arguments[]{ nullptr };
+
+            const char* const* argv;
+            Storage& storage;
+            bool expand_response_files{ false };
+            std::string_view response_file{};
+            std::string_view command_line{};
+            std::optional<ParseResult> error{};
+            std::optional<std::string_view> argument{};
+            std::optional<std::string_view> next_argument{};
+            // the position within argv if the argument was taken from there directly
+            const char* const* argument_origin{ nullptr };
+            const char* const* next_argument_origin{ nullptr };
+            usize char_offset{ 0 };
+
+            ArgumentsView(const char** const arguments, Storage& buffers, const bool response_files)
+                : argv{ arguments },
+                  storage{ buffers },
+                  expand_response_files{ response_files } {
+                ++argv;// skip program name
+                argument = fetch_argument(argument_origin);
+                next_argument = fetch_argument(next_argument_origin);
+            }
+
+            /// response files are not expanded since the command line might come from an untrusted source
+            ArgumentsView(const std::string_view words, Storage& buffers)
+                : argv{ no_arguments },
+                  storage{ buffers },
+                  command_line{ words } {
+                argument = fetch_argument(argument_origin);
+                next_argument = fetch_argument(next_argument_origin);
+            }
+
+            /// Replaces the current argument by the words of the response file it names if it has the form "@path" and
+            /// was taken from argv directly. This is only called for arguments that start a new option or are
+            /// positional, never for the values of parameters or the arguments after "--", and the words of a response
+            /// file are not expanded again. Returns false if the argument is no response file.
+            [[nodiscard]] bool expand_response_file() {
+                if (not expand_response_files or argument_origin == nullptr or char_offset != 0
+                    or argument->size() < 2 or argument->front() != '@') {
+                    return false;
+                }
+                const auto path = argument->substr(1);
+                // the words of the file come before the following argument, which has been fetched already
+                if (next_argument_origin != nullptr) {
+                    argv = next_argument_origin;
+                }
+                auto file = MappedFile::open(path.data(), storage.get_allocator());
+                if (not file) {
+                    error = result::CannotOpenResponseFile{
+                        .path{ std::pmr::string{ path, storage.get_allocator() } }
+                    };
+                    argument = next_argument = std::nullopt;
+                    return true;
+                }
+                response_file = file->contents();
+                storage.push_back(std::move(file));
+                argument = fetch_argument(argument_origin);
+                next_argument = argument ? fetch_argument(next_argument_origin) : std::nullopt;
+                return true;
+            }
+
+            [[nodiscard]] char current() const {
+                return char_offset < argument->size() ? (*argument)[char_offset] : ' ';
+            }
+
+            [[nodiscard]] char consume() {
+                const auto result = current();
+                advance();
+                return result;
+            }
+
+            [[nodiscard]] char peek() const {
+                assert(not eof());
+                if (char_offset < argument->size()) {
+                    return char_offset + 1 < argument->size() ? (*argument)[char_offset + 1] : ' ';
+                }
+                return next_argument->empty() ? ' ' : next_argument->front();
+            }
+
+            void skip(const usize count) {
+                char_offset += count;
+            }
+
+            void next_arg() {
+                argument = next_argument;
+                argument_origin = next_argument_origin;
+                next_argument_origin = nullptr;
+                next_argument = argument ? fetch_argument(next_argument_origin) : std::nullopt;
+                char_offset = 0;
+            }
+
+            void advance() {
+                if (eof()) {
+                    return;
+                }
+                if (char_offset < argument->size()) {
+                    ++char_offset;
+                } else {
+                    next_arg();
+                }
+            }
+
+            [[nodiscard]] std::string_view arg_tail() const {
+                return argument->substr(char_offset);
+            }
+
+            [[nodiscard]] std::string_view consume_arg() {
+                const auto result = arg_tail();
+                next_arg();
+                return result;
+            }
+
+            /// an empty last argument is not at the end yet, it still has to be taken as an (empty) value
+            [[nodiscard]] bool eof() const {
+                return not argument.has_value()
+                       or (not argument->empty() and char_offset >= argument->size() and not next_argument.has_value());
+            }
+
+            /// Takes the current and all following arguments. If the current argument was taken from argv directly,
+            /// the result is the rest of argv itself (the following arguments are taken as they are, i.e.
+            /// response files are not expanded). Otherwise, the remaining words are copied into the storage.
+            [[nodiscard]] std::span<const char* const> take_rest() {
+                if (argument_origin != nullptr) {
+                    auto end = argument_origin;
+                    while (*end != nullptr) {
+                        ++end;
+                    }
+                    const auto result = std::span{ argument_origin, end };
+                    argument = next_argument = std::nullopt;
+                    response_file = {};
+                    error = std::nullopt;
+                    return result;
+                }
+
+                struct RestWords final {
+                    explicit RestWords(const std::pmr::polymorphic_allocator<>& allocator)
+                        : words{ allocator },
+                          pointers{ allocator } { }
+
+                    std::pmr::vector<std::pmr::string> words;
+                    std::pmr::vector<const char*> pointers;
+                };
+                auto rest = std::allocate_shared<RestWords>(storage.get_allocator(), storage.get_allocator());
+                for (; argument.has_value(); next_arg()) {
+                    rest->words.emplace_back(*argument);
+                }
+                rest->pointers.reserve(rest->words.size());
+                for (const auto& word : rest->words) {
+                    rest->pointers.push_back(word.c_str());
+                }
+                const auto result = std::span<const char* const>{ rest->pointers };
+                storage.push_back(std::move(rest));
+                return result;
+            }
+
+        private:
+            [[nodiscard]] static bool is_separator(const char c) {
+                return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\v' or c == '\f';
+            }
+
+            [[nodiscard]] static bool is_escapable_in_double_quotes(const char c) {
+                return c == '$' or c == '`' or c == '"' or c == '\\' or c == '\n';
+            }
+
+            /// takes the next word from the front of the text
+            [[nodiscard]] std::optional<std::string_view> fetch_word(std::string_view& text) {
+                text = std::string_view{ std::find_if_not(text.begin(), text.end(), is_separator), text.end() };
+                if (text.empty()) {
+                    return {};
+                }
+
+                const auto special = text.find_first_of(" \t\n\r\v\f'\"\\");
+                if (special == std::string_view::npos or is_separator(text[special])) {
+                    const auto word = text.substr(0, special);
+                    text.remove_prefix(word.size());
+                    return word;
+                }
+
+                // a completely quoted word without escape sequences can be used without copying
+                const auto quote = text.front();
+                if (quote == '\'' or quote == '"') {
+                    const auto closing = text.find(quote, 1);
+                    if (closing != std::string_view::npos
+                        and (closing + 1 == text.size() or is_separator(text[closing + 1]))) {
+                        const auto word = text.substr(1, closing - 1);
+                        if (quote == '\'' or word.find('\\') == std::string_view::npos) {
+                            text.remove_prefix(closing + 1);
+                            return word;
+                        }
+                    }
+                }
+                return unquote_word(text);
+            }
+
+            [[nodiscard]] std::optional<std::string_view> unquote_word(std::string_view& text) {
+                auto word = std::allocate_shared<std::pmr::string>(storage.get_allocator());
+                usize i = 0;
+                while (i < text.size() and not is_separator(text[i])) {
+                    const auto c = text[i++];
+                    if (c == '\\') {
+                        if (i == text.size()) {
+                            word->push_back(c);
+                        } else if (text[i++] != '\n') {
+                            word->push_back(text[i - 1]);
+                        }
+                    } else if (c == '\'') {
+                        const auto closing = text.find('\'', i);
+                        if (closing == std::string_view::npos) {
+                            error = result::UnterminatedQuote{};
+                            return {};
+                        }
+                        word->append(text.substr(i, closing - i));
+                        i = closing + 1;
+                    } else if (c == '"') {
+                        while (true) {
+                            if (i == text.size()) {
+                                error = result::UnterminatedQuote{};
+                                return {};
+                            }
+                            const auto quoted = text[i++];
+                            if (quoted == '"') {
+                                break;
+                            }
+                            if (quoted == '\\' and i < text.size()
+                                and is_escapable_in_double_quotes(text[i])) {
+                                if (text[i] != '\n') {
+                                    word->push_back(text[i]);
+                                }
+                                ++i;
+                            } else {
+                                word->push_back(quoted);
+                            }
+                        }
+                    } else {
+                        word->push_back(c);
+                    }
+                }
+                text.remove_prefix(i);
+                const auto result = std::string_view{ *word };
+                storage.push_back(std::move(word));
+                return result;
+            }
+
+            [[nodiscard]] std::optional<std::string_view> fetch_argument(const char* const*& origin) {
+                origin = nullptr;
+                if (error) {
+                    return {};
+                }
+                if (not command_line.empty()) {
+                    return fetch_word(command_line);
+                }
+                if (not response_file.empty()) {
+                    if (const auto word = fetch_word(response_file); word or error) {
+                        return word;
+                    }
+                }
+                if (*argv == nullptr) {
+                    return {};
+                }
+                origin = argv;
+                return std::string_view{ *argv++ };
+            }
+        };
+
+    }// namespace detail
+
+    template<detail::String InfoText, detail::String HelpText, typename... Arguments>
+    class Schema;
+
+    template<detail::String InfoText, detail::String HelpText, typename... Arguments>
+    class Parser;
+
+    /// The result of parsing a command line. Objects of this type are returned by Schema::parse(). Response files
+    /// stay mapped as long as a result refers to them, so std::string_view values can point into them.
+    template<typename... Arguments>
+    class ParsedArgs final {
+    private:
+        /// all memory owned by the result is allocated from the given resource
+        explicit ParsedArgs(
+                const detail::ValueTuple<Arguments...>& default_values,
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        )
+            : m_values{ std::make_obj_using_allocator<detail::ValueTuple<Arguments...>>(
+                    std::pmr::polymorphic_allocator<>{ resource },
+                    default_values
+            ) },
+              m_storage{ resource } { }
+
+        [[nodiscard]] std::pmr::string make_string(const std::string_view text) const {
+            return std::pmr::string{ text, m_storage.get_allocator() };
+        }
+
+        static constexpr auto is_lazy = std::array<bool, sizeof...(Arguments)>{ detail::is_lazy<Arguments>()... };
+        static constexpr auto num_lazy = static_cast<detail::usize>(std::count(is_lazy.begin(), is_lazy.end(), true));
+        /// the index into m_unconverted_values for every lazily converted argument
+        static constexpr auto lazy_slots = detail::make_slots(is_lazy);
+        static constexpr auto is_view = std::array<bool, sizeof...(Arguments)>{
+            detail::is_view_v<typename Arguments::ValueType>...
+        };
+        static constexpr auto num_views = static_cast<detail::usize>(std::count(is_view.begin(), is_view.end(), true));
+        /// the index into m_view_hashes for every argument with a view value
+        static constexpr auto view_slots = detail::make_slots(is_view);
+
+        /// converts the value if its conversion is still pending, a failed conversion keeps the default value
+        template<detail::usize Index>
+        void convert_pending() {
+            if constexpr (is_lazy[Index]) {
+                auto& unconverted = m_unconverted_values[lazy_slots[Index]];
+                if (not unconverted) {
+                    return;
+                }
+                using T = std::tuple_element_t<Index, detail::ValueTuple<Arguments...>>;
+                auto value = std::make_obj_using_allocator<T>(m_storage.get_allocator());
+                if (converter<T>::convert(*unconverted, value)) {
+                    std::get<Index>(m_values) = std::move(value);
+                } else if (*this) {
+                    m_parse_result = result::ArgumentTypeMismatch{};
+                }
+                unconverted.reset();
+            }
+        }
+
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        /// Like all std::pmr types, copies use the default resource. These constructors copy into the given resource,
+        /// containers like std::pmr::vector<ParsedArgs> use them to pass on their resource.
+        ParsedArgs(std::allocator_arg_t, const allocator_type& allocator, const ParsedArgs& other)
+            : m_arguments_found{ other.m_arguments_found },
+              m_values{ std::make_obj_using_allocator<detail::ValueTuple<Arguments...>>(allocator, other.m_values) },
+              m_parse_result{ detail::copy_parse_result(other.m_parse_result, allocator) },
+              m_storage{ other.m_storage, allocator },
+              m_unconverted_values{ other.m_unconverted_values },
+              m_view_hashes{ other.m_view_hashes } { }
+
+        ParsedArgs(std::allocator_arg_t, const allocator_type& allocator, ParsedArgs&& other)
+            : m_arguments_found{ other.m_arguments_found },
+              m_values{ std::make_obj_using_allocator<detail::ValueTuple<Arguments...>>(
+                      allocator,
+                      std::move(other.m_values)
+              ) },
+              m_parse_result{ allocator == other.get_allocator()
+                                      ? std::move(other.m_parse_result)
+                                      : detail::copy_parse_result(other.m_parse_result, allocator) },
+              m_storage{ std::move(other.m_storage), allocator },
+              m_unconverted_values{ other.m_unconverted_values },
+              m_view_hashes{ other.m_view_hashes } { }
+
+        ParsedArgs(const ParsedArgs&) = default;
+        ParsedArgs(ParsedArgs&&) = default;
+        ParsedArgs& operator=(const ParsedArgs&) = default;
+        ParsedArgs& operator=(ParsedArgs&&) = default;
+        ~ParsedArgs() = default;
+
+        [[nodiscard]] allocator_type get_allocator() const {
+            return m_storage.get_allocator();
+        }
+
+        operator bool() const {
+            return std::holds_alternative<result::Okay>(m_parse_result);
+        }
+
+        [[nodiscard]] const detail::ParseResult& result() const {
+            return m_parse_result;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool result_is() const {
+            return std::holds_alternative<T>(m_parse_result);
         }
 
         template<char Abbreviation>
-        [[nodiscard]] consteval std::string_view get_name() {
-            static_assert(has_abbreviation<Abbreviation>(), "unknown abbreviation");
-            return get_name<Abbreviation, Arguments...>();
+        [[nodiscard]] bool was_provided() const {
+            return m_arguments_found[detail::index_of_abbreviation<Abbreviation, Arguments...>()];
+        }
+
+        /// In debug builds (DEBUG_BUILD), this asserts that the text a view value points to has not changed since
+        /// parsing. That is a best-effort check for modified command lines, not a lifetime check: if argv has been
+        /// destroyed already, reading the text is undefined behavior itself.
+        /// Values of types with a lazy converter can only be accessed through a non-const result (see below), so a
+        /// const result is never modified and can be shared between threads.
+        template<char Abbreviation>
+            requires(not is_lazy[detail::index_of_abbreviation<Abbreviation, Arguments...>()])
+        [[nodiscard]] const auto& get() const {
+            return value_at<detail::index_of_abbreviation<Abbreviation, Arguments...>()>();
+        }
+
+        /// Values of types with a lazy converter are converted here on first access. If that fails, the default value
+        /// is returned and the result becomes ArgumentTypeMismatch.
+        template<char Abbreviation>
+        [[nodiscard]] const auto& get() {
+            constexpr auto index = detail::index_of_abbreviation<Abbreviation, Arguments...>();
+            convert_pending<index>();
+            return value_at<index>();
+        }
+
+        /// returns a tuple of references to be used with structured bindings
+        template<char... Abbreviations>
+            requires(sizeof...(Abbreviations) > 1)
+        [[nodiscard]] auto get() const {
+            return std::forward_as_tuple(get<Abbreviations>()...);
+        }
+
+        template<char... Abbreviations>
+            requires(sizeof...(Abbreviations) > 1)
+        [[nodiscard]] auto get() {
+            return std::forward_as_tuple(get<Abbreviations>()...);
+        }
+
+        /// Converts all values whose conversion is still pending (see get()). Afterwards, the result reports
+        /// conversion errors like it does for types without a lazy converter. Returns false if parsing failed.
+        bool validate_all() {
+            [this]<detail::usize... Indices>(std::index_sequence<Indices...>) {
+                (convert_pending<Indices>(), ...);
+            }(std::index_sequence_for<Arguments...>{});
+            return static_cast<bool>(*this);
+        }
+
+    private:
+        template<detail::usize Index>
+        [[nodiscard]] const auto& value_at() const {
+            const auto& value = std::get<Index>(m_values);
+#ifdef DEBUG_BUILD
+            if constexpr (is_view[Index]) {
+                // the command line the value points into must not change as long as the parse result is used
+                assert((not m_arguments_found[Index]
+                        or detail::hash_name({ value.data(), value.size() }) == m_view_hashes[view_slots[Index]]));
+            }
+#endif
+            return value;
+        }
+
+        std::array<bool, sizeof...(Arguments)> m_arguments_found{};
+        detail::ValueTuple<Arguments...> m_values;
+        detail::ParseResult m_parse_result = result::NothingParsedYet{};
+        detail::Storage m_storage;
+        /// the text of the lazily converted values that have not been accessed yet
+        std::array<std::optional<std::string_view>, num_lazy> m_unconverted_values{};
+        /// The hashes of the text the view values pointed to when they were stored, see get(). They are written in
+        /// every build, so a result parsed without DEBUG_BUILD can be checked by code compiled with it.
+        std::array<std::uint64_t, num_views> m_view_hashes{};
+
+        template<detail::String, detail::String, typename...>
+        friend class Schema;
+
+        template<detail::String, detail::String, typename...>
+        friend class Parser;
+    };
+
+    /// The results of Schema::parse_lines() in the order of the input lines. Values of type std::string_view point
+    /// into a buffer owned by this object.
+    template<typename Result>
+    class ParsedLines final {
+    private:
+        ParsedLines(detail::SplitLines&& lines, std::pmr::vector<Result>&& results)
+            : m_lines{ std::move(lines) },
+              m_results{ std::move(results) } { }
+
+    public:
+        [[nodiscard]] detail::usize size() const {
+            return m_results.size();
+        }
+
+        [[nodiscard]] const Result& operator[](const detail::usize index) const {
+            return m_results[index];
+        }
+
+        [[nodiscard]] auto begin() const {
+            return m_results.cbegin();
+        }
+
+        [[nodiscard]] auto end() const {
+            return m_results.cend();
+        }
+
+    private:
+        detail::SplitLines m_lines;
+        std::pmr::vector<Result> m_results;
+
+        template<detail::String, detail::String, typename...>
+        friend class Schema;
+    };
+
+    /// Base class of the observers that can be passed to Schema::parse() and Parser::parse() to instrument the
+    /// parsing process. Hide the callbacks you are interested in, all others do nothing. Without an observer (or
+    /// with this one), all callbacks are compiled out.
+    struct Observer {
+        /// whether the duration of each conversion is measured and passed to on_convert()
+        static constexpr bool measures_time = false;
+
+        void on_parse_begin() { }
+        /// an argument is looked at (the separate values of named parameters are tokens as well)
+        void on_token(std::string_view) { }
+        /// the argument with the given index has been recognized
+        void on_option(detail::usize) { }
+        /// the value of the argument with the given index has been converted (zero duration if not measured)
+        void on_convert(detail::usize, std::chrono::nanoseconds) { }
+        /// the given number of bytes of the command line has been copied into a string value
+        void on_copy([[maybe_unused]] detail::usize bytes) { }
+        /// the parse failed, called before on_parse_end()
+        void on_error(const detail::ParseResult&) { }
+        void on_parse_end() { }
+    };
+
+    template<typename T>
+    concept ParseObserver = std::derived_from<T, Observer>;
+
+    /// Counts the allocations made from an upstream resource. Pass it to create() or Schema::parse() to see how
+    /// much memory a parse result needs.
+    class CountingResource final : public std::pmr::memory_resource {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* const upstream = std::pmr::get_default_resource())
+            : m_upstream{ upstream } { }
+
+        [[nodiscard]] detail::usize allocations() const {
+            return m_allocations;
+        }
+
+        [[nodiscard]] detail::usize bytes_allocated() const {
+            return m_bytes_allocated;
+        }
+
+    private:
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+            ++m_allocations;
+            m_bytes_allocated += bytes;
+            return m_upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* const pointer, const std::size_t bytes, const std::size_t alignment) override {
+            m_upstream->deallocate(pointer, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::memory_resource* m_upstream;
+        detail::usize m_allocations{ 0 };
+        detail::usize m_bytes_allocated{ 0 };
+    };
+
+    /// Counts what happens while parsing, summed up over all parses it observes. Allocations are only counted if
+    /// the result allocates from the observer's resource.
+    struct CountingObserver : Observer {
+        detail::usize parses{ 0 };
+        detail::usize tokens{ 0 };
+        detail::usize options{ 0 };
+        detail::usize conversions{ 0 };
+        /// the text copied into string values, other values are converted or point into the command line
+        detail::usize bytes_copied{ 0 };
+        detail::usize errors{ 0 };
+        CountingResource resource{};
+
+        [[nodiscard]] detail::usize allocations() const {
+            return resource.allocations();
+        }
+
+        void on_parse_begin() {
+            ++parses;
+        }
+
+        void on_token(std::string_view) {
+            ++tokens;
+        }
+
+        void on_option(detail::usize) {
+            ++options;
+        }
+
+        void on_convert(detail::usize, std::chrono::nanoseconds) {
+            ++conversions;
+        }
+
+        void on_copy(const detail::usize bytes) {
+            bytes_copied += bytes;
+        }
+
+        void on_error(const detail::ParseResult&) {
+            ++errors;
+        }
+    };
+
+    /// Measures the time spent parsing and converting values, summed up over all parses it observes.
+    struct TimingObserver : Observer {
+        static constexpr bool measures_time = true;
+
+        std::chrono::nanoseconds parse_time{ 0 };
+        std::chrono::nanoseconds conversion_time{ 0 };
+
+        void on_parse_begin() {
+            m_start = std::chrono::steady_clock::now();
         }
 
+        void on_convert(detail::usize, const std::chrono::nanoseconds duration) {
+            conversion_time += duration;
+        }
+
+        void on_parse_end() {
+            parse_time += std::chrono::steady_clock::now() - m_start;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start{};
+    };
+
+    /// The immutable description of all arguments. Parsing does not modify the schema, so a single instance can be
+    /// shared between threads that parse concurrently.
+    template<detail::String InfoText, detail::String HelpText, typename... Arguments>
+    class Schema {
+    private:
+        static constexpr auto abbreviations = std::array<char, sizeof...(Arguments)>{ Arguments::abbreviation... };
+        static constexpr auto kinds = std::array<detail::ArgumentKind, sizeof...(Arguments)>{
+            detail::kind_of<Arguments>()...
+        };
+        static constexpr auto is_view = std::array<bool, sizeof...(Arguments)>{
+            detail::is_view_v<typename Arguments::ValueType>...
+        };
+        static constexpr auto copies_text = std::array<bool, sizeof...(Arguments)>{
+            detail::copies_text<Arguments>()...
+        };
+        static constexpr auto dispatch_table = detail::make_dispatch_table<Arguments...>();
+        /// indices of the optionally named parameters in the order in which they are assigned
+        static constexpr auto positional_indices = [] {
+            auto result = std::array<detail::usize, detail::count_arguments<Arguments...>()>{};
+            auto position = result.begin();
+            for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                if (kinds[i] == detail::ArgumentKind::OptionallyNamedParameter) {
+                    *position++ = i;
+                }
+            }
+            return result;
+        }();
+        static constexpr auto rest_index = [] {
+            const auto position = std::find(kinds.begin(), kinds.end(), detail::ArgumentKind::RestParameter);
+            return position == kinds.end() ? std::optional<detail::usize>{}
+                                           : std::optional{ static_cast<detail::usize>(position - kinds.begin()) };
+        }();
+        static constexpr auto names = std::array<std::string_view, sizeof...(Arguments)>{ Arguments::name... };
+        /// the names of all arguments that can be given by name, sorted for the prefix search of the completion
+        static constexpr auto sorted_names = [] {
+            constexpr auto num_names = sizeof...(Arguments) - detail::count_rest_parameters<Arguments...>();
+            auto result = std::array<std::string_view, num_names>{};
+            auto position = result.begin();
+            for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                if (kinds[i] != detail::ArgumentKind::RestParameter) {
+                    *position++ = names[i];
+                }
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }();
+        static constexpr auto help_text_buffer = detail::make_help_text<HelpText, Arguments...>();
+        static constexpr auto info_text_buffer = detail::make_help_text<InfoText>();
+        static constexpr auto zsh_completion = detail::make_text<detail::ZshCompletion<Arguments...>>();
+        static constexpr auto fish_completion = detail::make_text<detail::FishCompletion<Arguments...>>();
+        static constexpr auto name_table = detail::make_perfect_hash_table(names);
+        static constexpr auto environment_variables = std::array<std::string_view, sizeof...(Arguments)>{
+            Arguments::environment_variable...
+        };
+        /// indices of the arguments that are bound to environment variables
+        static constexpr auto environment_indices = [] {
+            constexpr auto num_bindings = std::count_if(
+                    environment_variables.begin(), environment_variables.end(),
+                    [](const auto variable) { return not variable.empty(); }
+            );
+            auto result = std::array<detail::usize, static_cast<detail::usize>(num_bindings)>{};
+            auto position = result.begin();
+            for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                if (not environment_variables[i].empty()) {
+                    *position++ = i;
+                }
+            }
+            return result;
+        }();
+        static constexpr auto bound_environment_variables = [] {
+            auto result = std::array<std::string_view, environment_indices.size()>{};
+            for (detail::usize i = 0; i < environment_indices.size(); ++i) {
+                result[i] = environment_variables[environment_indices[i]];
+            }
+            return result;
+        }();
+        static constexpr auto environment_table = detail::make_perfect_hash_table(bound_environment_variables);
+        static constexpr auto environment_filter = detail::make_name_filter(bound_environment_variables);
+
+        using ValueAccessors = detail::ValueAccessors<
+                detail::ValueTuple<Arguments...>, std::index_sequence_for<Arguments...>, Arguments...>;
+
+    public:
+        using Result = ParsedArgs<Arguments...>;
+
+    private:
+        constexpr Schema(detail::ValueTuple<Arguments...>&& default_values, const bool response_files)
+            : m_default_values{ std::move(default_values) },
+              m_response_files{ response_files } { }
+
+    public:
+        template<char Abbreviation>
+        [[nodiscard]] static consteval bool has_abbreviation() {
+            return detail::has_abbreviation_impl<Abbreviation, Arguments...>();
+        }
+
+        [[nodiscard]] static constexpr std::optional<detail::usize> index_of_name(const std::string_view name) {
+            return name_table.find(name);
+        }
+
+        [[nodiscard]] static constexpr std::optional<char> get_abbreviation_of_name(const std::string_view name) {
+            const auto index = index_of_name(name);
+            if (not index) {
+                return {};
+            }
+            return abbreviations[*index];
+        }
+
+        [[nodiscard]] static constexpr const detail::DispatchEntry& dispatch_entry_of(const char abbreviation) {
+            return dispatch_table[static_cast<detail::u8>(abbreviation)];
+        }
+
+        [[nodiscard]] static constexpr bool is_flag(const char abbreviation) {
+            return dispatch_entry_of(abbreviation).kind == detail::ArgumentKind::Flag;
+        }
+
+        [[nodiscard]] static constexpr bool is_named_parameter(const char abbreviation) {
+            return dispatch_entry_of(abbreviation).kind == detail::ArgumentKind::NamedParameter;
+        }
+
+        [[nodiscard]] static constexpr bool is_optionally_named_parameter(const char abbreviation) {
+            return dispatch_entry_of(abbreviation).kind == detail::ArgumentKind::OptionallyNamedParameter;
+        }
+
+        [[nodiscard]] static constexpr bool is_multi_parameter(const char abbreviation) {
+            return dispatch_entry_of(abbreviation).kind == detail::ArgumentKind::MultiParameter;
+        }
+
+        [[nodiscard]] static constexpr bool is_rest_parameter(const char abbreviation) {
+            return dispatch_entry_of(abbreviation).kind == detail::ArgumentKind::RestParameter;
+        }
+
+        template<char Abbreviation>
+        [[nodiscard]] static consteval std::string_view get_name() {
+            return names[index_of<Abbreviation>()];
+        }
+
+        /// the complete help text, generated at compile time
+        [[nodiscard]] static constexpr std::string_view help_text() {
+            return std::string_view{ help_text_buffer.data(), help_text_buffer.size() };
+        }
+
+        [[nodiscard]] static constexpr std::string_view info_text() {
+            return std::string_view{ info_text_buffer.data(), info_text_buffer.size() };
+        }
+
+        /// writes the help text to a std::FILE* or a std::ostream with a single write
         void print_help(auto&& out) const {
-            const auto help_text = static_cast<std::string_view>(HelpText);
-            if (not help_text.empty()) {
-                fmt::print(std::forward<decltype(out)>(out), "{}\n", help_text);
+            detail::write_text(out, help_text());
+        }
+
+        void print_info(auto&& out) const {
+            detail::write_text(out, info_text());
+        }
+
+        /// Answers a completion request of the bash completion script: "program --__complete <cword> <words...>", where
+        /// the words start with the program name and cword is the index of the word to complete. The matching options
+        /// are written to the file, one per line. Nothing is written for words that are no options or that are values
+        /// of a parameter, so the shell falls back to completing file names. Returns false if argv is no completion
+        /// request. Nothing is allocated, the output is collected in a buffer on the stack.
+        static bool complete(const char** const argv, std::FILE* const out = stdout) {
+            using namespace std::string_view_literals;
+
+            if (argv[1] == nullptr or argv[1] != "--__complete"sv) {
+                return false;
             }
-            print_help<Arguments...>(std::forward<decltype(out)>(out), detail::max_name_length<Arguments...>());
+            if (argv[2] == nullptr) {
+                return true;
+            }
+            const auto cword_text = std::string_view{ argv[2] };
+            auto cword = detail::usize{ 0 };
+            const auto [end, error] = std::from_chars(cword_text.data(), cword_text.data() + cword_text.size(), cword);
+            if (error != std::errc{} or end != cword_text.data() + cword_text.size()) {
+                return true;
+            }
+
+            const auto words = argv + 3;
+            auto num_words = detail::usize{ 0 };
+            while (words[num_words] != nullptr) {
+                ++num_words;
+            }
+            if (cword > 0 and cword <= num_words and expects_value(words[cword - 1])) {
+                return true;
+            }
+            const auto word = (cword < num_words ? std::string_view{ words[cword] } : std::string_view{});
+
+            auto output = detail::OutputBuffer{ out };
+            if (word == "-") {
+                for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                    if (kinds[i] != detail::ArgumentKind::RestParameter and detail::is_alphanumeric(abbreviations[i])) {
+                        output.append('-');
+                        output.append(abbreviations[i]);
+                        output.append('\n');
+                    }
+                }
+            }
+            if (word == "-" or word.starts_with("--")) {
+                const auto prefix = word.substr(std::min(word.size(), detail::usize{ 2 }));
+                for (auto name = std::lower_bound(sorted_names.begin(), sorted_names.end(), prefix);
+                     name != sorted_names.end() and name->starts_with(prefix); ++name) {
+                    output.append("--");
+                    output.append(*name);
+                    output.append('\n');
+                }
+            }
+            return true;
+        }
+
+        /// Writes a completion script for the given shell. The options and their descriptions are generated at compile
+        /// time. The bash script asks the program itself (see complete()), the zsh and fish scripts are static.
+        static void print_completion_script(const Shell shell, const std::string_view program_name, auto&& out) {
+            const auto write = [&](const auto... parts) {
+                (detail::write_text(out, std::string_view{ parts }), ...);
+            };
+            switch (shell) {
+                case Shell::Bash:
+                    write("_arguably_complete() {\n"
+                          "    local IFS=$'\\n'\n"
+                          "    COMPREPLY=($(\"${COMP_WORDS[0]}\" --__complete \"$COMP_CWORD\" \"${COMP_WORDS[@]}\" "
+                          "2>/dev/null))\n"
+                          "}\n"
+                          "complete -o default -F _arguably_complete ",
+                          program_name, "\n");
+                    break;
+                case Shell::Zsh:
+                    write("#compdef ", program_name, "\n");
+                    write("compdef _arguably_", program_name, " ", program_name, "\n\n");
+                    write("_arguably_", program_name, "() {\n    _arguments -s -S \\\n");
+                    write(std::string_view{ zsh_completion.data(), zsh_completion.size() });
+                    write("        '*:argument:_files'\n}\n\n");
+                    write("if [ \"$funcstack[1]\" = \"_arguably_", program_name, "\" ]; then\n");
+                    write("    _arguably_", program_name, " \"$@\"\nfi\n");
+                    break;
+                case Shell::Fish:
+                    write("set -l program ", program_name, "\n");
+                    write(std::string_view{ fish_completion.data(), fish_completion.size() });
+                    break;
+            }
+        }
+
+        template<char Abbreviation>
+        [[nodiscard]] static consteval detail::usize index_of() {
+            static_assert(has_abbreviation<Abbreviation>(), "unknown abbreviation");
+            return dispatch_entry_of(Abbreviation).index;
+        }
+
+        /// the abbreviation must belong to one of the arguments
+        [[nodiscard]] static constexpr detail::usize index_of(const char abbreviation) {
+            assert(dispatch_entry_of(abbreviation).kind != detail::ArgumentKind::None);
+            return dispatch_entry_of(abbreviation).index;
+        }
+
+        [[nodiscard]] static detail::usize get_argc(const char** argv) {
+            detail::usize i;
+            for (i = 1; argv[i] != nullptr; ++i) { }
+            return i;
+        }
+
+        [[nodiscard]] Result
+        parse(char** argv, std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) const {
+            return parse(const_cast<const char**>(argv), resource);
+        }
+
+        /// all memory owned by the result is allocated from the given resource
+        [[nodiscard]] Result
+        parse(const char** argv, std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) const {
+            auto parsed = Result{ m_default_values, resource };
+            parse_impl(parsed, argv);
+            return parsed;
+        }
+
+        /// Parses a command line given as a single string (without the program name). The string is split into
+        /// arguments like a POSIX shell would do it. std::string_view values may point into the string.
+        [[nodiscard]] Result parse(
+                const std::string_view command_line,
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            auto parsed = Result{ m_default_values, resource };
+            parse_impl(parsed, command_line);
+            return parsed;
+        }
+
+        [[nodiscard]] Result parse(
+                char** argv,
+                ParseObserver auto& observer,
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            return parse(const_cast<const char**>(argv), observer, resource);
+        }
+
+        /// Same as parse(), but reports the progress to the observer (see Observer).
+        [[nodiscard]] Result parse(
+                const char** argv,
+                ParseObserver auto& observer,
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            auto parsed = Result{ m_default_values, resource };
+            parse_impl(parsed, argv, observer);
+            return parsed;
+        }
+
+        [[nodiscard]] Result parse(
+                const std::string_view command_line,
+                ParseObserver auto& observer,
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            auto parsed = Result{ m_default_values, resource };
+            parse_impl(parsed, command_line, observer);
+            return parsed;
+        }
+
+        void parse_into(Result& parsed, char** argv) const {
+            parse_into(parsed, const_cast<const char**>(argv));
         }
 
-        void print_info(auto&& out) const {
-            const auto info_text = static_cast<std::string_view>(InfoText);
-            if (not info_text.empty()) {
-                fmt::print(std::forward<decltype(out)>(out), "{}\n", info_text);
-            }
+        /// Parses into an existing result, reusing its storage. The result is reset before parsing.
+        void parse_into(Result& parsed, const char** argv) const {
+            reset(parsed);
+            parse_impl(parsed, argv);
         }
 
-        template<char Abbreviation>
-        [[nodiscard]] static consteval detail::usize index_of() {
-            return detail::index_of_impl<Abbreviation, 0, Arguments...>();
+        void parse_into(Result& parsed, const std::string_view command_line) const {
+            reset(parsed);
+            parse_impl(parsed, command_line);
         }
 
-        [[nodiscard]] static constexpr detail::usize index_of(const char abbreviation) {
-            return detail::index_of_impl<0, Arguments...>(abbreviation);
+        /// Parses many argument vectors in parallel. The results are returned in the order of the input. The results
+        /// and the vector that holds them are allocated from the given resource, which has to be thread-safe if more
+        /// than one thread is used (like the default resource and std::pmr::synchronized_pool_resource).
+        [[nodiscard]] std::pmr::vector<Result> parse_batch(
+                const std::span<const char** const> argument_vectors,
+                const detail::usize num_threads = detail::default_num_threads(),
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            auto results = std::pmr::vector<Result>(
+                    argument_vectors.size(), Result{ m_default_values, resource }, resource
+            );
+            detail::parallel_for(argument_vectors.size(), num_threads, [&](const detail::usize i) {
+                parse_impl(results[i], argument_vectors[i]);
+            });
+            return results;
         }
 
-        void print_default_values() const {
-            print_default_values_impl<0, Arguments...>(m_values);
+        /// Parses every line of the input as a separate command line (without a program name). Each line is split into
+        /// arguments like parse(std::string_view) does it, so quotes cannot span lines. The lines are parsed in
+        /// parallel, the results are returned in the order of the lines. Memory is allocated like by parse_batch().
+        [[nodiscard]] ParsedLines<Result> parse_lines(
+                const std::string_view lines,
+                const detail::usize num_threads = detail::default_num_threads(),
+                std::pmr::memory_resource* const resource = std::pmr::get_default_resource()
+        ) const {
+            auto split = detail::SplitLines{ lines, resource };
+            auto results = std::pmr::vector<Result>(split.size(), Result{ m_default_values, resource }, resource);
+            detail::parallel_for(split.size(), num_threads, [&](const detail::usize i) {
+                parse_impl(results[i], split.lines[i]);
+            });
+            return ParsedLines<Result>{ std::move(split), std::move(results) };
         }
 
-        template<char Abbreviation>
-        [[nodiscard]] bool was_provided() {
-            static_assert(has_abbreviation<Abbreviation>(), "unknown abbreviation");
-            static constexpr auto index = index_of<Abbreviation>();
-            return m_arguments_found[index];
+        /// Reads the values of the arguments that have not been given on the command line (or through the environment)
+        /// from a config file with one "name = value" pair per line. Empty lines and lines starting with '#' are
+        /// ignored, multi parameters collect the values of all of their lines. Call this after a successful parse.
+        /// The file is mapped into memory and read line by line, std::string_view values point into it.
+        void parse_config(Result& parsed, const char* const path) const {
+            if (not parsed) {
+                return;
+            }
+            auto file = detail::MappedFile::open(path, parsed.m_storage.get_allocator());
+            if (not file) {
+                parsed.m_parse_result = result::CannotOpenConfigFile{ parsed.make_string(path) };
+                return;
+            }
+            const auto contents = file->contents();
+            parsed.m_storage.push_back(std::move(file));
+            apply_config(parsed, contents);
         }
 
-        template<char Abbreviation>
-        [[nodiscard]] auto get() const {
-            static_assert(has_abbreviation<Abbreviation>(), "unknown abbreviation");
-            return get_value<Abbreviation, 0, Arguments...>(m_values);
+        /// Restores the default values of a result. Only the values of the arguments that were provided are
+        /// restored, all others still hold their default values.
+        void reset(Result& parsed) const {
+            for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                if (parsed.m_arguments_found[i]) {
+                    ValueAccessors::restore[i](parsed.m_values, m_default_values);
+                }
+            }
+            parsed.m_arguments_found = {};
+            parsed.m_parse_result = result::NothingParsedYet{};
+            parsed.m_storage.clear();
+            parsed.m_unconverted_values = {};
         }
 
-        [[nodiscard]] static detail::usize get_argc(const char** argv) {
-            detail::usize i;
-            for (i = 1; argv[i] != nullptr; ++i) { }
-            return i;
+    private:
+        /// whether the word after the given one is the value of a parameter
+        [[nodiscard]] static bool expects_value(const std::string_view word) {
+            const auto takes_value = [](const detail::ArgumentKind kind) {
+                return kind != detail::ArgumentKind::None and kind != detail::ArgumentKind::Flag
+                       and kind != detail::ArgumentKind::RestParameter;
+            };
+            if (word.starts_with("--")) {
+                const auto index = index_of_name(word.substr(2));
+                return index and takes_value(kinds[*index]);
+            }
+            if (word.size() < 2 or word[0] != '-') {
+                return false;
+            }
+            // in a cluster of flags, the first parameter takes the rest of the word as its value
+            for (detail::usize i = 1; i < word.size(); ++i) {
+                const auto kind = dispatch_entry_of(word[i]).kind;
+                if (kind != detail::ArgumentKind::Flag) {
+                    return takes_value(kind) and i + 1 == word.size();
+                }
+            }
+            return false;
         }
 
         enum class ParserState {
@@ -534,106 +2265,290 @@ namespace arguably {
             None,
         };
 
-        template<typename T>
-        [[nodiscard]] bool try_store_at(detail::usize index, T&& value) {
-            m_arguments_found[index] = true;
-            const auto success = store_at_impl<0, Arguments...>(m_values, index, std::forward<T>(value));
+        [[nodiscard]] static bool try_store_at(
+                Result& parsed,
+                const detail::usize index,
+                const std::string_view value,
+                ParseObserver auto& observer
+        ) {
+            parsed.m_arguments_found[index] = true;
+            observer.on_option(index);
+            if constexpr (Result::num_lazy > 0) {
+                if (Result::is_lazy[index]) {
+                    parsed.m_unconverted_values[Result::lazy_slots[index]] = value;
+                    return true;
+                }
+            }
+            auto duration = std::chrono::nanoseconds{ 0 };
+            auto success = false;
+            if constexpr (std::remove_reference_t<decltype(observer)>::measures_time) {
+                const auto start = std::chrono::steady_clock::now();
+                success = ValueAccessors::store[index](parsed.m_values, value);
+                duration = std::chrono::steady_clock::now() - start;
+            } else {
+                success = ValueAccessors::store[index](parsed.m_values, value);
+            }
+            observer.on_convert(index, duration);
+            if (copies_text[index]) {
+                observer.on_copy(value.size());
+            }
             if (not success) {
-                m_parse_result = result::ArgumentTypeMismatch{};
+                parsed.m_parse_result = result::ArgumentTypeMismatch{};
+            }
+            if (is_view[index]) {
+                parsed.m_view_hashes[Result::view_slots[index]] = detail::hash_name(value);
             }
             return success;
         }
 
-        void set_flag(detail::usize index) {
-            m_arguments_found[index] = true;
-            m_values[index] = true;
+        static void set_flag(Result& parsed, const detail::usize index, ParseObserver auto& observer) {
+            parsed.m_arguments_found[index] = true;
+            observer.on_option(index);
+            ValueAccessors::set_flag[index](parsed.m_values);
         }
 
-        void parse(char** argv) {
-            parse(const_cast<const char**>(argv));
+        void parse_impl(Result& parsed, const char** argv) const {
+            auto observer = Observer{};
+            parse_impl(parsed, argv, observer);
         }
 
-        void parse(const char** argv) {
-            if (not result_is<result::NothingParsedYet>()) {
-                m_parse_result = result::CannotParseAgain{};
+        static void parse_impl(Result& parsed, const std::string_view command_line) {
+            auto observer = Observer{};
+            parse_impl(parsed, command_line, observer);
+        }
+
+        void parse_impl(Result& parsed, const char** argv, ParseObserver auto& observer) const {
+            observer.on_parse_begin();
+            if constexpr (detail::count_multi_parameters<Arguments...>() > 0) {
+                reserve_multi_parameters(parsed, argv);
+            }
+            auto data = detail::ArgumentsView{ argv, parsed.m_storage, m_response_files };
+            parse_impl(parsed, data, observer);
+        }
+
+        static void parse_impl(Result& parsed, const std::string_view command_line, ParseObserver auto& observer) {
+            observer.on_parse_begin();
+            auto data = detail::ArgumentsView{ command_line, parsed.m_storage };
+            parse_impl(parsed, data, observer);
+        }
+
+        /// Counts how often each multi parameter appears in argv so that its vector does not have to grow while
+        /// parsing. Occurrences inside of flag clusters and response files are not counted.
+        static void reserve_multi_parameters(Result& parsed, const char** argv) {
+            auto counts = std::array<detail::usize, sizeof...(Arguments)>{};
+            for (auto current = argv + 1; *current != nullptr; ++current) {
+                // only the first characters are looked at, the length of positional arguments is never computed
+                const auto argument = *current;
+                if (argument[0] != '-' or argument[1] == '\0') {
+                    continue;
+                }
+                if (argument[1] != '-') {
+                    const auto [kind, index] = dispatch_entry_of(argument[1]);
+                    if (kind == detail::ArgumentKind::MultiParameter) {
+                        ++counts[index];
+                    }
+                    continue;
+                }
+                const auto name = std::string_view{ argument + 2, std::strcspn(argument + 2, "=") };
+                const auto index = index_of_name(name);
+                if (index and kinds[*index] == detail::ArgumentKind::MultiParameter) {
+                    ++counts[*index];
+                }
+            }
+            for (detail::usize i = 0; i < sizeof...(Arguments); ++i) {
+                if (counts[i] > 0) {
+                    ValueAccessors::reserve[i](parsed.m_values, counts[i]);
+                }
+            }
+        }
+
+        static void parse_impl(Result& parsed, detail::ArgumentsView& data, ParseObserver auto& observer) {
+            parse_arguments(parsed, data, observer);
+            if (data.error) {
+                parsed.m_parse_result = *data.error;
+            }
+            if constexpr (not environment_indices.empty()) {
+                if (parsed) {
+                    apply_environment(parsed, observer);
+                }
+            }
+            if (not parsed) {
+                observer.on_error(parsed.m_parse_result);
+            }
+            observer.on_parse_end();
+        }
+
+        static void apply_config(Result& parsed, std::string_view contents) {
+            // values given on the command line take precedence, later lines override earlier ones
+            auto observer = Observer{};
+            const auto provided = parsed.m_arguments_found;
+            for (auto line_number = std::size_t{ 1 }; not contents.empty(); ++line_number) {
+                const auto line_end = contents.find('\n');
+                const auto line = detail::trim(contents.substr(0, line_end));
+                contents.remove_prefix(line_end == std::string_view::npos ? contents.size() : line_end + 1);
+                if (line.empty() or line.front() == '#') {
+                    continue;
+                }
+
+                const auto equals_index = line.find('=');
+                if (equals_index == std::string_view::npos) {
+                    parsed.m_parse_result = result::InvalidConfigLine{ .line{ line_number } };
+                    return;
+                }
+                const auto name = detail::trim(line.substr(0, equals_index));
+                const auto index = index_of_name(name);
+                if (not index or kinds[*index] == detail::ArgumentKind::RestParameter) {
+                    parsed.m_parse_result = result::UnknownOption{ parsed.make_string(name) };
+                    return;
+                }
+                if (provided[*index]) {
+                    continue;
+                }
+                const auto value = detail::trim(line.substr(equals_index + 1));
+                if (value.empty()) {
+                    parsed.m_parse_result = result::MissingArgument{ .abbreviation{ abbreviations[*index] } };
+                    return;
+                }
+                if (not try_store_at(parsed, *index, value, observer)) {
+                    return;
+                }
+            }
+        }
+
+        /// Takes the values of the arguments that have not been given on the command line from the environment
+        /// variables they are bound to. The environment is only read if such an argument is missing, and then in a
+        /// single pass for all of them instead of one lookup per variable. Empty variables count as not set.
+        static void apply_environment(Result& parsed, ParseObserver auto& observer) {
+            auto missing = std::array<bool, environment_indices.size()>{};
+            auto num_missing = detail::usize{ 0 };
+            for (detail::usize i = 0; i < environment_indices.size(); ++i) {
+                missing[i] = not parsed.m_arguments_found[environment_indices[i]];
+                num_missing += missing[i];
+            }
+            if (num_missing == 0) {
                 return;
             }
 
-            auto data = detail::ArgumentsView{ .argc{ get_argc(argv) }, .argv{ argv } };
+            const auto apply = [&](const detail::usize binding, const std::string_view value) {
+                missing[binding] = false;
+                --num_missing;
+                return value.empty() or try_store_at(parsed, environment_indices[binding], value, observer);
+            };
+#ifdef ARGUABLY_USE_ENVIRON
+            const auto environment = detail::environment_block();
+            for (auto entry = environment; entry != nullptr and *entry != nullptr and num_missing > 0; ++entry) {
+                const auto equals = std::strchr(*entry, '=');
+                if (equals == nullptr) {
+                    continue;
+                }
+                const auto name = std::string_view{ *entry, equals };
+                if (not environment_filter.may_contain(name)) {
+                    continue;
+                }
+                // only the first definition of a variable counts (like for getenv())
+                const auto binding = environment_table.find(name);
+                if (binding and missing[*binding] and not apply(*binding, std::string_view{ equals + 1 })) {
+                    return;
+                }
+            }
+#else
+            for (detail::usize i = 0; i < environment_indices.size(); ++i) {
+                if (not missing[i]) {
+                    continue;
+                }
+                const auto value = std::getenv(environment_table.names[i].data());
+                if (value != nullptr and not apply(i, std::string_view{ value })) {
+                    return;
+                }
+            }
+#endif
+        }
+
+        static void parse_arguments(Result& parsed, detail::ArgumentsView& data, ParseObserver auto& observer) {
             auto state = ParserState::None;
+            auto positional_cursor = detail::usize{ 0 };
 
             while (not data.eof()) {
                 switch (state) {
-                    case ParserState::None:
-                        if (data.current() == '-') {
-                            const auto next = data.peek();
-                            if (next == '-') {
-                                state = ParserState::DoubleDashArgument;
-                                data.advance();// consume first dash
-                                if (isspace(data.peek())) {
-                                    state = ParserState::AfterFreestandingDoubleDash;
-                                    data.advance();// consume second dash
-                                    data.advance();// consume space
-                                    break;
-                                }
-                            } else if (isspace(next)) {
-                                const auto abbreviation =
-                                        detail::abbreviation_of_first_unseen_optionally_named<0, Arguments...>(
-                                                m_arguments_found
-                                        );
-                                if (not abbreviation.has_value()) {
-                                    m_parse_result = result::ExcessUnnamedArguments{};
-                                    return;
-                                }
-                                const auto index = index_of(*abbreviation);
-                                if (not try_store_at(index, "-")) {
-                                    return;
-                                }
-                            } else {
-                                state = ParserState::SingleDashArguments;
-                            }
-                            data.advance();
+                    case ParserState::None: {
+                        if (data.expand_response_file()) {
                             break;
                         }
-                        if (not std::isspace(data.current())) {
-                            if (not handle_unnamed_argument(data)) {
+                        // every argument is classified as a whole by its first two characters
+                        const auto argument = data.arg_tail();
+                        observer.on_token(argument);
+                        if (argument.size() <= 1 or argument[0] != '-') {
+                            if (not handle_unnamed_argument(parsed, data, positional_cursor, observer)) {
                                 return;
                             }
+                        } else if (argument[1] != '-') {
+                            state = ParserState::SingleDashArguments;
+                            data.skip(1);
+                        } else if (argument.size() == 2) {
+                            state = ParserState::AfterFreestandingDoubleDash;
+                            data.next_arg();
+                        } else {
+                            state = ParserState::DoubleDashArgument;
+                            data.skip(2);
                         }
                         break;
+                    }
                     case ParserState::SingleDashArguments: {
-                        if (not handle_single_dash_arguments(data, state)) {
+                        if (not handle_single_dash_arguments(parsed, data, state, observer)) {
                             return;
                         }
                         break;
                     }
                     case ParserState::DoubleDashArgument:
-                        if (not handle_double_dash_argument(data, state)) {
+                        if (not handle_double_dash_argument(parsed, data, state, observer)) {
                             return;
                         }
                         break;
                     case ParserState::AfterFreestandingDoubleDash:
-                        if (not handle_unnamed_argument(data)) {
+                        observer.on_token(data.arg_tail());
+                        if (not handle_unnamed_argument(parsed, data, positional_cursor, observer)) {
                             return;
                         }
                         break;
                 }
             }
-            m_parse_result = result::Okay{};
+            parsed.m_parse_result = result::Okay{};
+        }
+
+        /// The optionally named parameters are assigned in order. The cursor only moves forward and skips the ones
+        /// that have been given by name, so all of them are found in linear time in total.
+        [[nodiscard]] static std::optional<detail::usize>
+        index_of_next_positional(const Result& parsed, detail::usize& positional_cursor) {
+            while (positional_cursor < positional_indices.size()
+                   and parsed.m_arguments_found[positional_indices[positional_cursor]]) {
+                ++positional_cursor;
+            }
+            if (positional_cursor == positional_indices.size()) {
+                return {};
+            }
+            return positional_indices[positional_cursor];
         }
 
-    private:
         /// returns false on error
-        [[nodiscard]] bool handle_unnamed_argument(detail::ArgumentsView& data) {
+        [[nodiscard]] static bool handle_unnamed_argument(
+                Result& parsed,
+                detail::ArgumentsView& data,
+                detail::usize& positional_cursor,
+                ParseObserver auto& observer
+        ) {
             const auto argument = data.arg_tail();
-            const auto abbreviation =
-                    detail::abbreviation_of_first_unseen_optionally_named<0, Arguments...>(m_arguments_found);
-            if (not abbreviation.has_value()) {
-                m_parse_result = result::ExcessUnnamedArguments{};
+            const auto index = index_of_next_positional(parsed, positional_cursor);
+            if (not index.has_value()) {
+                if constexpr (rest_index.has_value()) {
+                    parsed.m_arguments_found[*rest_index] = true;
+                    observer.on_option(*rest_index);
+                    std::get<*rest_index>(parsed.m_values) = data.take_rest();
+                    return true;
+                }
+                parsed.m_parse_result = result::ExcessUnnamedArguments{};
                 return false;
             }
-            const auto index = index_of(*abbreviation);
-            if (not try_store_at(index, argument)) {
+            if (not try_store_at(parsed, *index, argument, observer)) {
                 return false;
             }
             data.next_arg();
@@ -641,93 +2556,101 @@ namespace arguably {
         }
 
         /// returns false on error
-        [[nodiscard]] bool handle_single_dash_arguments(detail::ArgumentsView& data, ParserState& state) {
+        [[nodiscard]] static bool handle_single_dash_arguments(
+                Result& parsed,
+                detail::ArgumentsView& data,
+                ParserState& state,
+                ParseObserver auto& observer
+        ) {
             if (isspace(data.current())) {
                 state = ParserState::None;
                 data.advance();
                 return true;
             }
-            if (is_flag(data.current())) {
-                const auto index = index_of(data.current());
-                set_flag(index);
+            const auto [kind, index] = dispatch_entry_of(data.current());
+            if (kind == detail::ArgumentKind::Flag) {
+                set_flag(parsed, index, observer);
                 data.advance();
-            } else if (is_named_parameter(data.current()) or is_optionally_named_parameter(data.current())) {
+            } else if (kind != detail::ArgumentKind::None and kind != detail::ArgumentKind::RestParameter) {
                 const auto parameter_abbreviation = data.consume();
                 const auto tail = data.arg_tail();
-                const auto index = index_of(parameter_abbreviation);
                 if (tail.empty()) {
                     data.next_arg();
                     if (data.eof()) {
-                        m_parse_result = result::MissingArgument{ .abbreviation{ parameter_abbreviation } };
+                        parsed.m_parse_result = result::MissingArgument{ .abbreviation{ parameter_abbreviation } };
                         return false;
                     }
                     const auto argument = data.arg_tail();
-                    if (not try_store_at(index, argument)) {
+                    observer.on_token(argument);
+                    if (not try_store_at(parsed, index, argument, observer)) {
                         return false;
                     }
                 } else {
-                    if (not try_store_at(index, tail)) {
+                    if (not try_store_at(parsed, index, tail, observer)) {
                         return false;
                     }
                 }
                 data.next_arg();
                 state = ParserState::None;
             } else {
-                m_parse_result = result::UnknownOption{ .option{ data.current() } };
+                parsed.m_parse_result = result::UnknownOption{ .option{ data.current() } };
                 return false;
             }
             return true;
         }
 
         /// returns false on error
-        [[nodiscard]] bool handle_double_dash_argument(detail::ArgumentsView& data, ParserState& state) {
+        [[nodiscard]] static bool handle_double_dash_argument(
+                Result& parsed,
+                detail::ArgumentsView& data,
+                ParserState& state,
+                ParseObserver auto& observer
+        ) {
             const auto arg_tail = data.arg_tail();
             const auto equals_index = arg_tail.find('=');
             const auto equals_found = (equals_index != decltype(arg_tail)::npos);
 
             if (equals_found) {
                 const auto parameter = arg_tail.substr(0, equals_index);
-                const auto abbreviation = get_abbreviation_of_name(parameter);
-                if (not abbreviation) {
-                    m_parse_result = result::UnknownOption{ std::string{ parameter } };
+                const auto index = index_of_name(parameter);
+                if (not index or kinds[*index] == detail::ArgumentKind::RestParameter) {
+                    parsed.m_parse_result = result::UnknownOption{ parsed.make_string(parameter) };
                     return false;
                 }
-                if (is_flag(*abbreviation)) {
-                    m_parse_result = result::CannotSetValueOfFlag{ std::string{ parameter } };
+                if (kinds[*index] == detail::ArgumentKind::Flag) {
+                    parsed.m_parse_result = result::CannotSetValueOfFlag{ parsed.make_string(parameter) };
                     return false;
                 }
 
                 const auto argument = arg_tail.substr(equals_index + 1);
                 if (argument.empty()) {
-                    m_parse_result = result::MissingArgument{};
+                    parsed.m_parse_result = result::MissingArgument{};
                     return false;
                 }
 
-                const auto index = index_of(*abbreviation);
-                if (not try_store_at(index, argument)) {
+                if (not try_store_at(parsed, *index, argument, observer)) {
                     return false;
                 }
                 data.next_arg();
             } else {
                 const auto parameter = arg_tail;
-                const auto abbreviation = get_abbreviation_of_name(parameter);
-                if (not abbreviation) {
-                    m_parse_result = result::UnknownOption{ std::string{ parameter } };
+                const auto index = index_of_name(parameter);
+                if (not index or kinds[*index] == detail::ArgumentKind::RestParameter) {
+                    parsed.m_parse_result = result::UnknownOption{ parsed.make_string(parameter) };
                     return false;
                 }
 
-                if (is_flag(*abbreviation)) {
-                    const auto index = index_of(*abbreviation);
-                    set_flag(index);
+                if (kinds[*index] == detail::ArgumentKind::Flag) {
+                    set_flag(parsed, *index, observer);
                 } else {
                     data.next_arg();
                     if (data.eof()) {
-                        m_parse_result = result::MissingArgument{};
+                        parsed.m_parse_result = result::MissingArgument{};
                         return false;
                     }
                     const auto argument = data.arg_tail();
-                    const auto index = index_of(*abbreviation);
-                    if (not try_store_at(index, argument)) {
+                    observer.on_token(argument);
+                    if (not try_store_at(parsed, *index, argument, observer)) {
                         return false;
                     }
                 }
@@ -738,80 +2661,425 @@ namespace arguably {
         }
 
     private:
-        std::array<bool, sizeof...(Arguments)> m_arguments_found{};
-        detail::AnyVector m_values;
-        detail::ParseResult m_parse_result = result::NothingParsedYet{};
+        detail::ValueTuple<Arguments...> m_default_values;
+        bool m_response_files;
 
-        template<detail::String, detail::String, typename...>
+        template<detail::String, detail::String, typename, typename...>
         friend class ParserBuilder;
+
+        template<detail::String, detail::String, typename...>
+        friend class Parser;
     };
 
+    /// A schema that stores the result of a single parse. Use the schema directly (see schema()) to parse several
+    /// command lines, possibly concurrently.
     template<detail::String InfoText, detail::String HelpText, typename... Arguments>
+    class Parser final : public Schema<InfoText, HelpText, Arguments...> {
+    private:
+        using SchemaType = Schema<InfoText, HelpText, Arguments...>;
+
+        constexpr Parser(
+                detail::ValueTuple<Arguments...>&& default_values,
+                const bool response_files,
+                std::pmr::memory_resource* const resource
+        )
+            : SchemaType{ std::move(default_values), response_files },
+              m_parsed{ this->m_default_values, resource } { }
+
+    public:
+        [[nodiscard]] const SchemaType& schema() const {
+            return *this;
+        }
+
+        operator bool() const {
+            return static_cast<bool>(m_parsed);
+        }
+
+        [[nodiscard]] const detail::ParseResult& result() const {
+            return m_parsed.result();
+        }
+
+        template<typename T>
+        [[nodiscard]] bool result_is() const {
+            return m_parsed.template result_is<T>();
+        }
+
+        template<char Abbreviation>
+        [[nodiscard]] bool was_provided() const {
+            return m_parsed.template was_provided<Abbreviation>();
+        }
+
+        template<char... Abbreviations>
+        [[nodiscard]] decltype(auto) get() const {
+            return m_parsed.template get<Abbreviations...>();
+        }
+
+        /// values with a lazy converter can only be accessed through a non-const parser, see ParsedArgs::get()
+        template<char... Abbreviations>
+        [[nodiscard]] decltype(auto) get() {
+            return m_parsed.template get<Abbreviations...>();
+        }
+
+        /// see ParsedArgs::validate_all()
+        bool validate_all() {
+            return m_parsed.validate_all();
+        }
+
+        /// restores the default values and allows the parser to parse again
+        void reset() {
+            SchemaType::reset(m_parsed);
+        }
+
+        void parse_fresh(char** argv) {
+            parse_fresh(const_cast<const char**>(argv));
+        }
+
+        /// same as calling reset() and then parse()
+        void parse_fresh(const char** argv) {
+            SchemaType::parse_into(m_parsed, argv);
+        }
+
+        void parse_fresh(const std::string_view command_line) {
+            SchemaType::parse_into(m_parsed, command_line);
+        }
+
+        void parse(char** argv) {
+            parse(const_cast<const char**>(argv));
+        }
+
+        void parse(const char** argv) {
+            auto observer = Observer{};
+            parse(argv, observer);
+        }
+
+        void parse(char** argv, ParseObserver auto& observer) {
+            parse(const_cast<const char**>(argv), observer);
+        }
+
+        /// Answers completion requests of the generated completion scripts (see Schema::complete()). The result
+        /// is CompletionWritten then, and the program should exit. The progress is reported to the observer.
+        void parse(const char** argv, ParseObserver auto& observer) {
+            if (not result_is<result::NothingParsedYet>()) {
+                m_parsed.m_parse_result = result::CannotParseAgain{};
+                observer.on_error(m_parsed.m_parse_result);
+                return;
+            }
+            if (SchemaType::complete(argv)) {
+                m_parsed.m_parse_result = result::CompletionWritten{};
+                return;
+            }
+            SchemaType::parse_impl(m_parsed, argv, observer);
+        }
+
+        void parse(const std::string_view command_line) {
+            auto observer = Observer{};
+            parse(command_line, observer);
+        }
+
+        /// parses a command line given as a single string, see Schema::parse()
+        void parse(const std::string_view command_line, ParseObserver auto& observer) {
+            if (not result_is<result::NothingParsedYet>()) {
+                m_parsed.m_parse_result = result::CannotParseAgain{};
+                observer.on_error(m_parsed.m_parse_result);
+                return;
+            }
+            SchemaType::parse_impl(m_parsed, command_line, observer);
+        }
+
+        /// see Schema::parse_config()
+        void parse_config(const char* const path) {
+            SchemaType::parse_config(m_parsed, path);
+        }
+
+    private:
+        ParsedArgs<Arguments...> m_parsed;
+
+        template<detail::String, detail::String, typename, typename...>
+        friend class ParserBuilder;
+    };
+
+    template<detail::String InfoText, detail::String HelpText, typename DefaultValues, typename... Arguments>
     class ParserBuilder final {
     private:
         constexpr ParserBuilder() = default;
 
-        explicit ParserBuilder(detail::AnyVector&& default_values) : m_default_values{ std::move(default_values) } { }
+        explicit ParserBuilder(DefaultValues&& default_values, const bool response_files = false)
+            : m_default_values{ std::move(default_values) },
+              m_response_files{ response_files } { }
 
-        template<detail::String, detail::String, typename...>
+        template<detail::String, detail::String, typename, typename...>
         friend class ParserBuilder;
 
     public:
         template<char Abbreviation, detail::String Name, detail::String Description>
         [[nodiscard]] auto flag() {
             detail::check_reserved<Abbreviation, Name>();
-            detail::check_duplicate<Arguments..., detail::Flag<Abbreviation, Name, Description>>();
-            m_default_values.emplace_back(false);
-            return ParserBuilder<InfoText, HelpText, Arguments..., detail::Flag<Abbreviation, Name, Description>>{
-                std::move(m_default_values)
+            return ParserBuilder<
+                    InfoText, HelpText, detail::DefaultValueNode<DefaultValues, bool>, Arguments...,
+                    detail::Flag<Abbreviation, Name, Description>>{
+                { std::move(m_default_values), false },
+                m_response_files
             };
         }
 
         template<char Abbreviation, detail::String Name, detail::String Description, typename Type>
         [[nodiscard]] auto named(Type&& default_value) {
             detail::check_reserved<Abbreviation, Name>();
-            detail::check_duplicate<Arguments..., detail::NamedParameter<Abbreviation, Name, Description, Type>>();
-            m_default_values.emplace_back(std::forward<Type>(default_value));
             return ParserBuilder<
-                    InfoText, HelpText, Arguments..., detail::NamedParameter<Abbreviation, Name, Description, Type>>{
-                std::move(m_default_values)
+                    InfoText, HelpText, detail::DefaultValueNode<DefaultValues, Type>, Arguments...,
+                    detail::NamedParameter<Abbreviation, Name, Description, Type>>{
+                { std::move(m_default_values), std::forward<Type>(default_value) },
+                m_response_files
             };
         }
 
         template<char Abbreviation, detail::String Name, detail::String Description, typename Type>
         [[nodiscard]] auto optionally_named(Type&& default_value) {
             detail::check_reserved<Abbreviation, Name>();
-            detail::check_duplicate<
-                    Arguments..., detail::OptionallyNamedParameter<Abbreviation, Name, Description, Type>>();
-            m_default_values.emplace_back(std::forward<Type>(default_value));
             return ParserBuilder<
-                    InfoText, HelpText, Arguments...,
-                    detail::OptionallyNamedParameter<Abbreviation, Name, Description, Type>>{ std::move(m_default_values
-            ) };
+                    InfoText, HelpText, detail::DefaultValueNode<DefaultValues, Type>, Arguments...,
+                    detail::OptionallyNamedParameter<Abbreviation, Name, Description, Type>>{
+                { std::move(m_default_values), std::forward<Type>(default_value) },
+                m_response_files
+            };
+        }
+
+        /// adds a named parameter that can be given multiple times (e.g. "-I a -I b"), the values are collected in a
+        /// std::pmr::vector<Type>
+        template<char Abbreviation, detail::String Name, detail::String Description, typename Type>
+        [[nodiscard]] auto multi() {
+            detail::check_reserved<Abbreviation, Name>();
+            return ParserBuilder<
+                    InfoText, HelpText, detail::DefaultValueNode<DefaultValues, std::pmr::vector<Type>>, Arguments...,
+                    detail::MultiParameter<Abbreviation, Name, Description, Type>>{
+                { std::move(m_default_values), std::pmr::vector<Type>{} },
+                m_response_files
+            };
+        }
+
+        /// adds a parameter that captures all unnamed arguments that are left over after the optionally named
+        /// parameters got their values, starting with the first of them until the end of the command line
+        template<char Abbreviation, detail::String Name, detail::String Description>
+        [[nodiscard]] auto rest() {
+            detail::check_reserved<Abbreviation, Name>();
+            static_assert(detail::count_rest_parameters<Arguments...>() == 0, "there can only be one rest parameter");
+            return ParserBuilder<
+                    InfoText, HelpText, detail::DefaultValueNode<DefaultValues, std::span<const char* const>>,
+                    Arguments..., detail::RestParameter<Abbreviation, Name, Description>>{
+                { std::move(m_default_values), std::span<const char* const>{} },
+                m_response_files
+            };
+        }
+
+        /// Takes the value of the argument from the given environment variable if the argument is not given on the
+        /// command line. The value is converted like a value on the command line (flags accept e.g. "1" and "0").
+        template<char Abbreviation, detail::String Variable>
+        [[nodiscard]] auto env() {
+            static_assert(detail::has_abbreviation_impl<Abbreviation, Arguments...>(), "unknown abbreviation");
+            static_assert(not static_cast<std::string_view>(Variable).empty(), "the variable name must not be empty");
+            static_assert(
+                    ((Arguments::abbreviation != Abbreviation or not detail::is_rest_parameter(Arguments{})) and ...),
+                    "the rest parameter cannot be bound to an environment variable"
+            );
+            return ParserBuilder<
+                    InfoText, HelpText, DefaultValues,
+                    detail::bind_environment_t<Arguments, Abbreviation, Variable>...>{
+                std::move(m_default_values), m_response_files
+            };
+        }
+
+        /// Replaces arguments of the form "@path" by the words of the file at that path (see ArgumentsView). Only
+        /// arguments that are neither the value of a parameter nor follow "--" are expanded.
+        [[nodiscard]] auto response_files() {
+            return ParserBuilder{ std::move(m_default_values), true };
         }
 
         template<detail::String NewHelpText>
         [[nodiscard]] auto help() {
-            return ParserBuilder<InfoText, NewHelpText, Arguments...>{ std::move(m_default_values) };
+            return ParserBuilder<InfoText, NewHelpText, DefaultValues, Arguments...>{
+                std::move(m_default_values), m_response_files
+            };
         }
 
         template<detail::String NewInfoText>
         [[nodiscard]] auto info() {
-            return ParserBuilder<NewInfoText, HelpText, Arguments...>{ std::move(m_default_values) };
+            return ParserBuilder<NewInfoText, HelpText, DefaultValues, Arguments...>{
+                std::move(m_default_values), m_response_files
+            };
+        }
+
+        /// all memory owned by the parse result is allocated from the given resource
+        [[nodiscard]] auto create(std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) {
+            detail::check_duplicates<Arguments...>();
+            return Parser<InfoText, HelpText, Arguments...>{
+                detail::flatten_default_values<detail::ValueTuple<Arguments...>>(std::move(m_default_values)),
+                m_response_files, resource
+            };
+        }
+
+        [[nodiscard]] auto create_schema() {
+            detail::check_duplicates<Arguments...>();
+            return Schema<InfoText, HelpText, Arguments...>{
+                detail::flatten_default_values<detail::ValueTuple<Arguments...>>(std::move(m_default_values)),
+                m_response_files
+            };
+        }
+
+    private:
+        DefaultValues m_default_values;
+        bool m_response_files{ false };
+
+        friend inline ParserBuilder<
+                "",
+                "",
+                detail::DefaultValueNode<detail::EmptyDefaultValues, bool>,
+                detail::Flag<'h', "help", "show help">>
+        create_parser();
+    };
+
+    namespace detail {
+        using InitialParserBuilder = ParserBuilder<
+                "",
+                "",
+                DefaultValueNode<EmptyDefaultValues, bool>,
+                Flag<'h', "help", "show help">>;
+    }// namespace detail
+
+    [[nodiscard]] inline detail::InitialParserBuilder create_parser() {
+        return detail::InitialParserBuilder{ { {}, false } };
+    }
+
+    namespace detail {
+        template<String Name, typename SchemaType>
+        struct Subcommand final {
+            using Schema = SchemaType;
+            using Result = typename SchemaType::Result;
+
+            constexpr static std::string_view name{ static_cast<std::string_view>(Name) };
+        };
+    }// namespace detail
+
+    /// Selects one of several schemas by the first argument (like "git commit ..."), the selected schema parses the
+    /// remaining arguments. Only the schema of the selected subcommand is used at runtime. Like a schema, this is
+    /// immutable and can be shared between threads that parse concurrently.
+    template<typename... Subcommands>
+    class SubcommandSchema final {
+    public:
+        /// holds the result of the selected subcommand, or UnknownSubcommand (always at index 0)
+        using Result = std::variant<result::UnknownSubcommand, typename Subcommands::Result...>;
+
+    private:
+        using Schemas = std::tuple<typename Subcommands::Schema...>;
+        using ParseFunction = Result (*)(const Schemas&, const char**, std::pmr::memory_resource*);
+
+        static constexpr auto names = std::array<std::string_view, sizeof...(Subcommands)>{ Subcommands::name... };
+        static constexpr auto name_table = detail::make_perfect_hash_table(names);
+
+        template<detail::usize Index>
+        [[nodiscard]] static Result
+        parse_subcommand(const Schemas& schemas, const char** const argv, std::pmr::memory_resource* const resource) {
+            return Result{ std::in_place_index<Index + 1>, std::get<Index>(schemas).parse(argv, resource) };
+        }
+
+        static constexpr auto parse_functions = []<detail::usize... Indices>(std::index_sequence<Indices...>) {
+            return std::array<ParseFunction, sizeof...(Subcommands)>{ &parse_subcommand<Indices>... };
+        }(std::index_sequence_for<Subcommands...>{});
+
+        explicit SubcommandSchema(Schemas&& schemas) : m_schemas{ std::move(schemas) } { }
+
+    public:
+        /// the index of the result of the given subcommand within Result
+        template<detail::String Name>
+        [[nodiscard]] static consteval detail::usize index_of() {
+            constexpr auto index = name_table.find(static_cast<std::string_view>(Name));
+            static_assert(index.has_value(), "unknown subcommand");
+            return *index + 1;
+        }
+
+        /// returns nullptr if the given subcommand has not been selected
+        template<detail::String Name>
+        [[nodiscard]] static const auto* get_if(const Result& parsed) {
+            return std::get_if<index_of<Name>()>(&parsed);
+        }
+
+        /// values with a lazy converter can only be accessed through a non-const result, see ParsedArgs::get()
+        template<detail::String Name>
+        [[nodiscard]] static auto* get_if(Result& parsed) {
+            return std::get_if<index_of<Name>()>(&parsed);
+        }
+
+        template<detail::String Name>
+        [[nodiscard]] const auto& schema() const {
+            return std::get<index_of<Name>() - 1>(m_schemas);
+        }
+
+        [[nodiscard]] Result
+        parse(char** argv, std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) const {
+            return parse(const_cast<const char**>(argv), resource);
+        }
+
+        /// the subcommand takes the place of the program name for the schema of the subcommand
+        [[nodiscard]] Result
+        parse(const char** argv, std::pmr::memory_resource* const resource = std::pmr::get_default_resource()) const {
+            if (argv[1] == nullptr) {
+                return Result{ std::in_place_index<0>, result::UnknownSubcommand{ std::pmr::string{ resource } } };
+            }
+            const auto name = std::string_view{ argv[1] };
+            const auto index = name_table.find(name);
+            if (not index) {
+                return Result{
+                    std::in_place_index<0>, result::UnknownSubcommand{ std::pmr::string{ name, resource } }
+                };
+            }
+            return parse_functions[*index](m_schemas, argv + 1, resource);
+        }
+
+    private:
+        Schemas m_schemas;
+
+        template<typename, typename...>
+        friend class SubcommandSchemaBuilder;
+    };
+
+    /// collects the schemas in a chain of nodes, see ParserBuilder
+    template<typename SchemaNodes, typename... Subcommands>
+    class SubcommandSchemaBuilder final {
+    private:
+        explicit SubcommandSchemaBuilder(SchemaNodes&& schemas) : m_schemas{ std::move(schemas) } { }
+
+        template<typename, typename...>
+        friend class SubcommandSchemaBuilder;
+
+    public:
+        /// adds a subcommand that is parsed by the schema of the given ParserBuilder
+        template<detail::String Name, typename Builder>
+        [[nodiscard]] auto subcommand(Builder&& builder) {
+            static_assert(not static_cast<std::string_view>(Name).empty(), "the subcommand name must not be empty");
+            auto schema = std::forward<Builder>(builder).create_schema();
+            using SchemaType = decltype(schema);
+            return SubcommandSchemaBuilder<
+                    detail::DefaultValueNode<SchemaNodes, SchemaType>, Subcommands...,
+                    detail::Subcommand<Name, SchemaType>>{
+                { std::move(m_schemas), std::move(schema) }
+            };
         }
 
         [[nodiscard]] auto create() {
-            return Parser<InfoText, HelpText, Arguments...>{ std::move(m_default_values) };
+            static_assert(sizeof...(Subcommands) > 0, "there has to be at least one subcommand");
+            static_assert(detail::has_unique_names<Subcommands...>(), "duplicate subcommand names are not allowed");
+            return SubcommandSchema<Subcommands...>{
+                detail::flatten_default_values<std::tuple<typename Subcommands::Schema...>>(std::move(m_schemas))
+            };
         }
 
     private:
-        detail::AnyVector m_default_values;
+        SchemaNodes m_schemas;
 
-        friend inline ParserBuilder<"", "", detail::Flag<'h', "help", "show help">> create_parser();
+        friend inline SubcommandSchemaBuilder<detail::EmptyDefaultValues> create_subcommands();
     };
 
-    [[nodiscard]] inline ParserBuilder<"", "", detail::Flag<'h', "help", "show help">> create_parser() {
-        return ParserBuilder<"", "", detail::Flag<'h', "help", "show help">>{ detail::AnyVector{ { false } } };
+    [[nodiscard]] inline SubcommandSchemaBuilder<detail::EmptyDefaultValues> create_subcommands() {
+        return SubcommandSchemaBuilder<detail::EmptyDefaultValues>{ {} };
     }
 
 }// namespace arguably
@@ -0,0 +1,263 @@
+// Exact allocation budgets of the parse paths. This is the only test executable that replaces the global allocation
+// functions (see global_allocations.cpp), so every check of global allocations belongs here.
+
+#include "global_allocations.hpp"
+#include <arguably.hpp>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+struct AllocationCounts {
+    std::size_t allocations;
+    std::size_t deallocations;
+};
+
+/// the allocations and deallocations made while calling the function
+template<typename Function>
+[[nodiscard]] static AllocationCounts count_allocations(Function&& function) {
+    const auto allocations_before = num_global_allocations();
+    const auto deallocations_before = num_global_deallocations();
+    function();
+    return AllocationCounts{ .allocations{ num_global_allocations() - allocations_before },
+                             .deallocations{ num_global_deallocations() - deallocations_before } };
+}
+
+[[nodiscard]] static std::string write_temporary_file(const std::string_view name, const std::string_view contents) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    auto stream = std::ofstream{ path, std::ios::binary };
+    stream << contents;
+    return path.string();
+}
+
+/// longer than the small string buffer of every standard library
+static constexpr auto long_text = std::string_view{ "a/path/that/does/not/fit/into/the/small/string/buffer.txt" };
+
+static auto make_parser() {
+    return arguably::create_parser()
+            .flag<'a', "all", "">()
+            .flag<'t', "tree", "">()
+            .flag<'z', "zip", "">()
+            .named<'n', "count", "", int>(1)
+            .named<'u', "limit", "", unsigned long long>(0)
+            .named<'r', "ratio", "", double>(0.0)
+            .named<'o', "output", "", std::string>("a.out")
+            .multi<'I', "include", "", std::string_view>()
+            .optionally_named<'i', "input", "", std::string_view>("-")
+            .optionally_named<'s', "second_input", "", std::string_view>("-")
+            .create();
+}
+
+/// parses with a parser that has been created before, and reads all given values
+template<char... Abbreviations>
+static AllocationCounts count_parse_allocations(const char** argv) {
+    auto parser = make_parser();
+    return count_allocations([&] {
+        parser.parse(argv);
+        ASSERT_TRUE(parser);
+        (static_cast<void>(parser.get<Abbreviations>()), ...);
+    });
+}
+
+TEST(Allocations, FlagsOnly) {
+    const char* argv[] = { "a.out", "-at", "--zip", "-a", nullptr };
+    const auto counts = count_parse_allocations<'a', 't', 'z'>(argv);
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, NumericNamedParameters) {
+    const char* argv[] = {
+        "a.out", "-n", "12345", "--limit=18446744073709551615", "--ratio", "3.14", "-n-42", nullptr
+    };
+    const auto counts = count_parse_allocations<'n', 'u', 'r'>(argv);
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, StringViewPositionals) {
+    const auto input = std::string{ long_text };
+    const char* argv[] = { "a.out", input.c_str(), "--", "-", nullptr };
+    const auto counts = count_parse_allocations<'i', 's'>(argv);
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, ShortStringValueIsNotAllocated) {
+    const char* argv[] = { "a.out", "--output=b.out", nullptr };
+    const auto counts = count_parse_allocations<'o'>(argv);
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, LongStringValueIsCopiedOnce) {
+    const auto output = "--output=" + std::string{ long_text };
+    const char* argv[] = { "a.out", output.c_str(), nullptr };
+    const auto counts = count_parse_allocations<'o'>(argv);
+    EXPECT_EQ(counts.allocations, 1);
+}
+
+TEST(Allocations, MultiParameterReservesOnce) {
+    const char* argv[] = { "a.out", "-Ia", "--include", "b", "-I", "c", "--include=d", nullptr };
+    const auto counts = count_parse_allocations<'I'>(argv);
+    EXPECT_EQ(counts.allocations, 1);
+}
+
+TEST(Allocations, ErrorPaths) {
+    const auto unknown_long_option = "--" + std::string{ long_text };
+    const char* unknown_abbreviation[] = { "a.out", "-x", nullptr };
+    const char* unknown_name[] = { "a.out", unknown_long_option.c_str(), nullptr };
+    const char* type_mismatch[] = { "a.out", "--count=many", nullptr };
+    const char* missing_argument[] = { "a.out", "--count", nullptr };
+    const char* excess_arguments[] = { "a.out", "first", "second", "third", nullptr };
+    auto parser = make_parser();
+
+    const auto parse = [&](const char** argv) {
+        return count_allocations([&] { parser.parse_fresh(argv); }).allocations;
+    };
+    EXPECT_EQ(parse(unknown_abbreviation), 0);
+    EXPECT_TRUE(parser.result_is<arguably::result::UnknownOption>());
+    // the name of the unknown option is copied into the result
+    EXPECT_EQ(parse(unknown_name), 1);
+    EXPECT_TRUE(parser.result_is<arguably::result::UnknownOption>());
+    EXPECT_EQ(parse(type_mismatch), 0);
+    EXPECT_TRUE(parser.result_is<arguably::result::ArgumentTypeMismatch>());
+    EXPECT_EQ(parse(missing_argument), 0);
+    EXPECT_TRUE(parser.result_is<arguably::result::MissingArgument>());
+    EXPECT_EQ(parse(excess_arguments), 0);
+    EXPECT_TRUE(parser.result_is<arguably::result::ExcessUnnamedArguments>());
+}
+
+TEST(Allocations, CommandLineString) {
+    auto parser = make_parser();
+    const auto unquoted = count_allocations([&] { parser.parse_fresh(R"(-at --count 3 "input file.txt")"); });
+    EXPECT_TRUE(parser);
+    EXPECT_EQ(unquoted.allocations, 0);
+
+    // a word with escapes is copied into a shared string that is kept in the storage of the result
+    const auto escaped = count_allocations([&] { parser.parse_fresh(R"(-n 3 'it'\''s')"); });
+    EXPECT_TRUE(parser);
+    EXPECT_EQ(escaped.allocations, 2);
+}
+
+TEST(Allocations, SchemaResults) {
+    const char* argv[] = { "a.out", "-at", "-n", "3", "input.txt", nullptr };
+    const auto schema = make_parser().schema();
+    const auto counts = count_allocations([&] {
+        auto parsed = schema.parse(argv);
+        ASSERT_TRUE(parsed);
+        schema.parse_into(parsed, argv);
+        ASSERT_TRUE(parsed);
+    });
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, BatchesWithMemoryResource) {
+    const auto output = std::string{ long_text };
+    const auto include = "-I" + output;
+    const char* first[] = { "a.out", "--output", output.c_str(), include.c_str(), "input.txt", nullptr };
+    const char* second[] = { "a.out", "-x", nullptr };
+    const auto argument_vectors = std::array{ first, second, first };
+    const auto lines = "--output " + output + " 'input file.txt'\n-x\n";
+    const auto schema = arguably::create_parser()
+                                .named<'o', "output", "", std::pmr::string>(std::pmr::string{})
+                                .multi<'I', "include", "", std::pmr::string>()
+                                .optionally_named<'i', "input", "", std::string_view>("-")
+                                .create_schema();
+    auto buffer = std::array<std::byte, 16 * 1024>{};
+    auto resource = std::pmr::monotonic_buffer_resource{
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+    };
+
+    // small batches are parsed on the calling thread, so nothing else needs the global heap
+    const auto counts = count_allocations([&] {
+        const auto results = schema.parse_batch(argument_vectors, 4, &resource);
+        ASSERT_EQ(results.size(), 3);
+        EXPECT_EQ(results[2].get<'o'>(), long_text);
+        EXPECT_EQ(results[2].get<'I'>().front(), long_text);
+        EXPECT_TRUE(results[1].result_is<arguably::result::UnknownOption>());
+        const auto parsed_lines = schema.parse_lines(lines, 4, &resource);
+        ASSERT_EQ(parsed_lines.size(), 2);
+        EXPECT_EQ(parsed_lines[0].get<'o'>(), long_text);
+        EXPECT_EQ(parsed_lines[0].get<'i'>(), "input file.txt");
+        EXPECT_TRUE(parsed_lines[1].result_is<arguably::result::UnknownOption>());
+    });
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, CompletionRequest) {
+    const char* argv[] = { "prog", "--__complete", "1", "prog", "--does_not_exist", nullptr };
+    auto parser = make_parser();
+    const auto counts = count_allocations([&] { parser.parse(argv); });
+    EXPECT_TRUE(parser.result_is<arguably::result::CompletionWritten>());
+    EXPECT_EQ(counts.allocations, 0);
+}
+
+TEST(Allocations, NoGlobalAllocationsWithMemoryResource) {
+    const auto path = write_temporary_file("arguably_response_file_arena.txt", "--define SOME_RATHER_LONG_MACRO_NAME");
+    const auto response_argument = "@" + path;
+    const char* argv[] = { "a.out",
+                           "--output=a/path/that/does/not/fit/into/the/small/string/buffer.txt",
+                           "-I/usr/include/some/long/include/path",
+                           "-I/usr/local/include/another/long/include/path",
+                           response_argument.c_str(),
+                           "an input file with a long name.txt",
+                           "rest",
+                           nullptr };
+    const char* failing_argv[] = { "a.out", "--some-unknown-option-with-a-long-name", nullptr };
+    auto buffer = std::array<std::byte, 16 * 1024>{};
+    auto resource = std::pmr::monotonic_buffer_resource{
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+    };
+    auto output = std::pmr::string{ &resource };
+    auto includes = std::size_t{ 0 };
+    auto defines = std::size_t{ 0 };
+    auto input = std::pmr::string{ &resource };
+    auto rest = std::size_t{ 0 };
+    auto failed_with_unknown_option = false;
+
+    const auto counts = count_allocations([&] {
+        auto parser = arguably::create_parser()
+                              .named<'o', "output", "", std::pmr::string>(std::pmr::string{ "a.out", &resource })
+                              .multi<'I', "include", "", std::pmr::string>()
+                              .multi<'D', "define", "", std::pmr::string>()
+                              .optionally_named<'i', "input", "", std::pmr::string>(std::pmr::string{ &resource })
+                              .rest<'r', "rest", "">()
+                              .response_files()
+                              .create(&resource);
+        parser.parse(argv);
+        if (parser) {
+            output = parser.get<'o'>();
+            includes = parser.get<'I'>().size();
+            defines = parser.get<'D'>().size();
+            input = parser.get<'i'>();
+            rest = parser.get<'r'>().size();
+        }
+        parser.parse_fresh(failing_argv);
+        failed_with_unknown_option = parser.result_is<arguably::result::UnknownOption>();
+    });
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(counts.allocations, 0);
+    EXPECT_EQ(output, "a/path/that/does/not/fit/into/the/small/string/buffer.txt");
+    EXPECT_EQ(includes, 2);
+    EXPECT_EQ(defines, 1);
+    EXPECT_EQ(input, "an input file with a long name.txt");
+    EXPECT_EQ(rest, 1);
+    EXPECT_TRUE(failed_with_unknown_option);
+}
+
+TEST(Allocations, EverythingIsFreedWithTheParser) {
+    const auto output = "--output=" + std::string{ long_text };
+    const auto unknown_long_option = "--" + std::string{ long_text };
+    const char* argv[] = { "a.out", output.c_str(), "-Ia", "-Ib", nullptr };
+    const char* failing_argv[] = { "a.out", unknown_long_option.c_str(), nullptr };
+    const auto counts = count_allocations([&] {
+        auto parser = make_parser();
+        parser.parse(argv);
+        ASSERT_TRUE(parser);
+        parser.parse_fresh(failing_argv);
+        ASSERT_FALSE(parser);
+    });
+    EXPECT_EQ(counts.allocations, counts.deallocations);
+}
@@ -0,0 +1,78 @@
+// Replaces the global allocation functions to count allocations and deallocations (see global_allocations.hpp).
+
+#include "global_allocations.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static std::atomic<std::size_t> num_allocations{ 0 };
+static std::atomic<std::size_t> num_deallocations{ 0 };
+
+std::size_t num_global_allocations() {
+    return num_allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t num_global_deallocations() {
+    return num_deallocations.load(std::memory_order_relaxed);
+}
+
+static void count_deallocation(const void* const pointer) {
+    if (pointer != nullptr) {
+        num_deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// the replacement operators pair malloc and free, GCC cannot see through that
+#if defined(__GNUC__) and not defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(const std::size_t size) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (const auto pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const pointer) noexcept {
+    count_deallocation(pointer);
+    std::free(pointer);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+// std::pmr::new_delete_resource() uses the aligned overloads, MSVC has no std::aligned_alloc
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded_size = (size == 0 ? align : (size + align - 1) / align * align);
+#ifdef _WIN32
+    const auto pointer = _aligned_malloc(rounded_size, align);
+#else
+    const auto pointer = std::aligned_alloc(align, rounded_size);
+#endif
+    if (pointer != nullptr) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const pointer, std::align_val_t) noexcept {
+    count_deallocation(pointer);
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void operator delete(void* const pointer, std::size_t, const std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
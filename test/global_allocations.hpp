@@ -0,0 +1,12 @@
+// Counters of the replacement global allocation functions in global_allocations.cpp. Link that file into a test or
+// benchmark executable to count every allocation of the program, including those of the standard library.
+
+#pragma once
+
+#include <cstddef>
+
+/// the number of calls to the global operator new so far
+[[nodiscard]] std::size_t num_global_allocations();
+
+/// the number of calls to the global operator delete with a pointer other than nullptr so far
+[[nodiscard]] std::size_t num_global_deallocations();
@@ -3,8 +3,54 @@
 //
 
 #include <arguably.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct Point {
+    int x;
+    int y;
+};
+
+template<>
+struct arguably::converter<Point> {
+    [[nodiscard]] static bool convert(const std::string_view input, Point& target) {
+        const auto comma = input.find(',');
+        if (comma == std::string_view::npos) {
+            return false;
+        }
+        return arguably::converter<int>::convert(input.substr(0, comma), target.x)
+               and arguably::converter<int>::convert(input.substr(comma + 1), target.y);
+    }
+};
+
+/// counts its conversions, they are deferred until the value is accessed
+struct ExpensiveValue {
+    int value;
+};
+
+static int num_expensive_conversions = 0;
+
+template<>
+struct arguably::converter<ExpensiveValue> {
+    static constexpr bool lazy = true;
+
+    [[nodiscard]] static bool convert(const std::string_view input, ExpensiveValue& target) {
+        ++num_expensive_conversions;
+        return arguably::converter<int>::convert(input, target.value);
+    }
+};
 
 TEST(Parser, FlagsOnly) {
     auto parser = arguably::create_parser()
@@ -641,6 +687,120 @@ TEST(Parser, UseNonConstArgumentVector) {
     EXPECT_EQ(parser.get<'i'>(), 43);
 }
 
+TEST(Parser, HelpTextIsGeneratedAtCompileTime) {
+    using Parser = decltype(arguably::create_parser()
+                                    .named<'o', "output", "the output file", std::string>("a.out")
+                                    .flag<'v', "verbose", "">()
+                                    .help<"usage: program [options]">()
+                                    .info<"program 1.0">()
+                                    .create());
+    static_assert(
+            Parser::help_text()
+            == "usage: program [options]\n"
+               "-h, --help     show help\n"
+               "-o, --output   the output file\n"
+               "-v, --verbose  \n"
+    );
+    static_assert(Parser::info_text() == "program 1.0\n");
+}
+
+TEST(Parser, PrintHelpToFile) {
+    auto parser = arguably::create_parser().flag<'a', "a_arg", "This is the description of a">().create();
+    const auto file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    parser.print_help(file);
+    std::rewind(file);
+    auto contents = std::string(parser.help_text().size() + 1, '\0');
+    contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(contents, "-h, --help   show help\n-a, --a_arg  This is the description of a\n");
+}
+
+[[nodiscard]] static std::string read_file(std::FILE* const file) {
+    std::rewind(file);
+    auto contents = std::string{};
+    auto buffer = std::array<char, 256>{};
+    for (auto count = std::fread(buffer.data(), 1, buffer.size(), file); count > 0;
+         count = std::fread(buffer.data(), 1, buffer.size(), file)) {
+        contents.append(buffer.data(), count);
+    }
+    return contents;
+}
+
+TEST(Parser, CompleteOptionNames) {
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .flag<'c', "color", "">()
+                                .named<'o', "output", "", std::string>("a.out")
+                                .named<'C', "config", "", std::string>("")
+                                .flag<'?', "query", "">()
+                                .rest<'f', "files", "">()
+                                .create_schema();
+    const auto complete = [&](std::vector<const char*> argv) {
+        argv.push_back(nullptr);
+        const auto file = std::tmpfile();
+        EXPECT_TRUE(schema.complete(argv.data(), file));
+        auto contents = read_file(file);
+        std::fclose(file);
+        return contents;
+    };
+
+    EXPECT_EQ(complete({ "prog", "--__complete", "1", "prog", "--co" }), "--color\n--config\n");
+    EXPECT_EQ(complete({ "prog", "--__complete", "2", "prog", "-v", "--o" }), "--output\n");
+    const auto all_long_names = std::string{ "--color\n--config\n--help\n--output\n--query\n--verbose\n" };
+    EXPECT_EQ(complete({ "prog", "--__complete", "1", "prog", "--" }), all_long_names);
+    EXPECT_EQ(complete({ "prog", "--__complete", "1", "prog", "-" }), "-h\n-v\n-c\n-o\n-C\n" + all_long_names);
+    EXPECT_EQ(complete({ "prog", "--__complete", "1", "prog", "--x" }), "");
+    EXPECT_EQ(complete({ "prog", "--__complete", "1", "prog", "fi" }), "");
+    EXPECT_EQ(complete({ "prog", "--__complete", "2", "prog", "--output", "--" }), "");
+    EXPECT_EQ(complete({ "prog", "--__complete", "2", "prog", "-vo", "-" }), "");
+    EXPECT_NE(complete({ "prog", "--__complete", "2", "prog", "-vofile", "-" }), "");
+    EXPECT_EQ(complete({ "prog", "--__complete", "2", "prog", "--co" }), "");
+
+    const char* argv[] = { "prog", "--verbose", nullptr };
+    EXPECT_FALSE(schema.complete(argv));
+}
+
+TEST(Parser, ParseAnswersCompletionRequests) {
+    const char* argv[] = { "prog", "--__complete", "1", "prog", "--does_not_exist", nullptr };
+    auto parser = arguably::create_parser().flag<'v', "verbose", "">().create();
+    parser.parse(argv);
+    EXPECT_TRUE(parser.result_is<arguably::result::CompletionWritten>());
+}
+
+TEST(Parser, CompletionScripts) {
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "print what's going on">()
+                                .named<'o', "output", "the output file [default: a.out]", std::string>("a.out")
+                                .multi<'I', "include", "", std::string>()
+                                .create_schema();
+    const auto script = [&](const arguably::Shell shell) {
+        auto stream = std::stringstream{};
+        schema.print_completion_script(shell, "prog", stream);
+        return stream.str();
+    };
+
+    EXPECT_EQ(
+            script(arguably::Shell::Fish),
+            "set -l program prog\n"
+            "complete -c $program -s h -l help -d 'show help'\n"
+            "complete -c $program -s v -l verbose -d 'print what\\'s going on'\n"
+            "complete -c $program -s o -l output -r -d 'the output file [default: a.out]'\n"
+            "complete -c $program -s I -l include -r\n"
+    );
+    const auto zsh = script(arguably::Shell::Zsh);
+    EXPECT_TRUE(zsh.starts_with("#compdef prog\ncompdef _arguably_prog prog\n"));
+    EXPECT_NE(zsh.find("'(-v --verbose)'{-v,--verbose}'[print what'\\''s going on]' \\\n"), std::string::npos);
+    EXPECT_NE(
+            zsh.find("'(-o --output)'{-o+,--output=}'[the output file [default\\: a.out\\]]:output:_files' \\\n"),
+            std::string::npos
+    );
+    EXPECT_NE(zsh.find("'*'{-I+,--include=}'[]:include:_files' \\\n"), std::string::npos);
+    EXPECT_NE(
+            script(arguably::Shell::Bash).find("complete -o default -F _arguably_complete prog\n"), std::string::npos
+    );
+}
+
 TEST(Parser, InfoText) {
     auto parser = arguably::create_parser().info<"info">().help<"help">().create();
     std::stringstream stream;
@@ -678,3 +838,1156 @@ TEST(Parser, ParserHasHelpFlag_IsFalseIfNotSet) {
     EXPECT_TRUE(parser);
     EXPECT_FALSE(parser.get<'h'>());
 }
+
+TEST(Parser, GetReturnsReferenceToStoredValue) {
+    auto parser = arguably::create_parser().named<'o', "output", "", std::string>("-").create();
+    const char* argv[] = { "backseat.exe", "-ooutput_filename", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    const auto& first = parser.get<'o'>();
+    const auto& second = parser.get<'o'>();
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(first, "output_filename");
+}
+
+TEST(Parser, GetMultipleValuesAsStructuredBindings) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string>("-")
+                          .named<'n', "number", "", int>(42)
+                          .create();
+    const char* argv[] = { "backseat.exe", "-v", "--output=my_code.bs", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    const auto [verbose, output, number] = parser.get<'v', 'o', 'n'>();
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(output, "my_code.bs");
+    EXPECT_EQ(number, 42);
+}
+
+TEST(Parser, FloatingPointArgument) {
+    auto parser = arguably::create_parser().named<'r', "ratio", "", double>(1.0).create();
+    const char* argv[] = { "backseat.exe", "--ratio=0.25", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_DOUBLE_EQ(parser.get<'r'>(), 0.25);
+}
+
+TEST(Parser, IntegerArgument_TrailingCharactersAreRejected) {
+    auto parser = arguably::create_parser().named<'i', "integer", "", int>(42).create();
+    const char* argv[] = { "backseat.exe", "-i43abc", nullptr };
+
+    parser.parse(argv);
+
+    EXPECT_FALSE(parser);
+    EXPECT_TRUE(parser.result_is<arguably::result::ArgumentTypeMismatch>());
+}
+
+TEST(Parser, UnsignedArgument_NegativeValueIsRejected) {
+    auto parser = arguably::create_parser().named<'u', "unsigned", "", unsigned>(42u).create();
+    const char* argv[] = { "backseat.exe", "-u", "-1", nullptr };
+
+    parser.parse(argv);
+
+    EXPECT_FALSE(parser);
+    EXPECT_TRUE(parser.result_is<arguably::result::ArgumentTypeMismatch>());
+}
+
+TEST(Parser, BoolArgument) {
+    auto parser = arguably::create_parser()
+                          .named<'c', "color", "", bool>(false)
+                          .named<'p', "pager", "", bool>(true)
+                          .create();
+    const char* argv[] = { "backseat.exe", "--color=true", "-p0", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'c'>());
+    EXPECT_FALSE(parser.get<'p'>());
+}
+
+TEST(Parser, StringArgumentKeepsWhitespace) {
+    auto parser = arguably::create_parser().named<'m', "message", "", std::string>("-").create();
+    const char* argv[] = { "backseat.exe", "-m", "hello world", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'m'>(), "hello world");
+}
+
+TEST(Parser, StringViewArgumentPointsIntoArgumentVector) {
+    auto parser = arguably::create_parser().named<'o', "output", "", std::string_view>("-").create();
+    const char* argv[] = { "backseat.exe", "--output=my_code.bs", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'o'>(), "my_code.bs");
+    EXPECT_EQ(parser.get<'o'>().data(), argv[1] + 9);
+}
+
+TEST(Parser, CustomConverter) {
+    auto parser = arguably::create_parser().named<'p', "point", "", Point>(Point{ 0, 0 }).create();
+    const char* argv[] = { "backseat.exe", "--point=3,4", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'p'>().x, 3);
+    EXPECT_EQ(parser.get<'p'>().y, 4);
+}
+
+TEST(Parser, LongNameLookupRejectsPrefixesAndUnknownNames) {
+    using Parser = decltype(arguably::create_parser()
+                                    .flag<'v', "verbose", "">()
+                                    .named<'o', "output", "", std::string>("")
+                                    .named<'O', "output_directory", "", std::string>("")
+                                    .create());
+
+    EXPECT_EQ(Parser::get_abbreviation_of_name("help"), 'h');
+    EXPECT_EQ(Parser::get_abbreviation_of_name("verbose"), 'v');
+    EXPECT_EQ(Parser::get_abbreviation_of_name("output"), 'o');
+    EXPECT_EQ(Parser::get_abbreviation_of_name("output_directory"), 'O');
+    EXPECT_FALSE(Parser::get_abbreviation_of_name("out").has_value());
+    EXPECT_FALSE(Parser::get_abbreviation_of_name("verbosee").has_value());
+    EXPECT_FALSE(Parser::get_abbreviation_of_name("").has_value());
+}
+
+TEST(Parser, ShortOptionClassification) {
+    using Parser = decltype(arguably::create_parser()
+                                    .flag<'v', "verbose", "">()
+                                    .named<'o', "output", "", std::string>("")
+                                    .optionally_named<'i', "input", "", std::string>("")
+                                    .create());
+
+    EXPECT_TRUE(Parser::is_flag('v'));
+    EXPECT_TRUE(Parser::is_flag('h'));
+    EXPECT_TRUE(Parser::is_named_parameter('o'));
+    EXPECT_TRUE(Parser::is_optionally_named_parameter('i'));
+    EXPECT_FALSE(Parser::is_flag('o'));
+    EXPECT_FALSE(Parser::is_named_parameter('x'));
+    EXPECT_FALSE(Parser::is_optionally_named_parameter('\xff'));
+    EXPECT_EQ(Parser::index_of('h'), 0);
+    EXPECT_EQ(Parser::index_of('i'), 3);
+}
+
+TEST(Parser, UnknownNonAsciiShortOption) {
+    auto parser = arguably::create_parser().flag<'v', "verbose", "">().create();
+    const char* argv[] = { "a.out", "-v\xc3\xa4", nullptr };
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser.result_is<arguably::result::UnknownOption>());
+}
+
+TEST(Parser, ResetRestoresDefaultValues) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string>("a.out")
+                          .named<'n', "count", "", int>(1)
+                          .create();
+    const char* first_argv[] = { "a.out", "-v", "--output=result.txt", nullptr };
+    const char* second_argv[] = { "a.out", "-n", "42", nullptr };
+
+    parser.parse(first_argv);
+    ASSERT_TRUE(parser);
+
+    parser.reset();
+
+    EXPECT_TRUE(parser.result_is<arguably::result::NothingParsedYet>());
+    EXPECT_FALSE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'o'>(), "a.out");
+    EXPECT_FALSE(parser.was_provided<'o'>());
+
+    parser.parse(second_argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_FALSE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'o'>(), "a.out");
+    EXPECT_EQ(parser.get<'n'>(), 42);
+    EXPECT_TRUE(parser.was_provided<'n'>());
+}
+
+TEST(Parser, ParseFreshAfterFailedParse) {
+    auto parser = arguably::create_parser()
+                          .named<'n', "count", "", int>(1)
+                          .optionally_named<'f', "file", "", std::string>("-")
+                          .create();
+    const char* failing_argv[] = { "a.out", "input.txt", "-n", "many", nullptr };
+    const char* argv[] = { "a.out", "other.txt", nullptr };
+
+    parser.parse_fresh(failing_argv);
+    ASSERT_TRUE(parser.result_is<arguably::result::ArgumentTypeMismatch>());
+
+    parser.parse_fresh(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'n'>(), 1);
+    EXPECT_EQ(parser.get<'f'>(), "other.txt");
+}
+
+[[nodiscard]] static std::string write_temporary_file(const std::string_view name, const std::string_view contents) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    auto stream = std::ofstream{ path, std::ios::binary };
+    stream << contents;
+    return path.string();
+}
+
+TEST(Parser, ViewValuesPointIntoArgv) {
+    const char* argv[] = { "a.out", "--output=result.txt", "-ppath/to/file", "input.txt", nullptr };
+    auto parser = arguably::create_parser()
+                          .named<'o', "output", "", std::string_view>("a.out")
+                          .named<'p', "path", "", std::span<const char>>({})
+                          .optionally_named<'i', "input", "", std::string_view>("-")
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'o'>().data(), argv[1] + 9);
+    EXPECT_EQ(parser.get<'o'>(), "result.txt");
+    EXPECT_EQ(parser.get<'p'>().data(), argv[2] + 2);
+    EXPECT_EQ(parser.get<'p'>().size(), 12);
+    EXPECT_EQ(parser.get<'i'>().data(), argv[3]);
+}
+
+#ifdef DEBUG_BUILD
+TEST(ParserDeathTest, ChangedViewValueIsDetected) {
+    auto parser = arguably::create_parser().named<'o', "output", "", std::string_view>("a.out").create();
+    auto output = std::string{ "--output=result.txt" };
+    const char* argv[] = { "a.out", output.c_str(), nullptr };
+    parser.parse(argv);
+    ASSERT_EQ(parser.get<'o'>(), "result.txt");
+
+    output.replace(9, 6, "change");
+
+    EXPECT_DEATH(static_cast<void>(parser.get<'o'>()), "");
+}
+#endif
+
+TEST(Parser, MultiParameter) {
+    const char* argv[] = { "a.out", "-I", "a", "--include", "b", "-Ic", "--include=d", "-n", "1", "-n2", nullptr };
+    auto parser = arguably::create_parser()
+                          .multi<'I', "include", "", std::string>()
+                          .multi<'n', "number", "", int>()
+                          .multi<'x', "exclude", "", std::string_view>()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'I'>(), (std::pmr::vector<std::string>{ "a", "b", "c", "d" }));
+    EXPECT_EQ(parser.get<'n'>(), (std::pmr::vector<int>{ 1, 2 }));
+    EXPECT_TRUE(parser.get<'x'>().empty());
+    EXPECT_TRUE(parser.was_provided<'I'>());
+    EXPECT_FALSE(parser.was_provided<'x'>());
+    EXPECT_TRUE(decltype(parser)::is_multi_parameter('I'));
+}
+
+TEST(Parser, MultiParameterReservesCapacity) {
+    auto arguments = std::vector<const char*>{ "a.out" };
+    for (int i = 0; i < 1000; ++i) {
+        arguments.push_back("-Ipath");
+    }
+    arguments.push_back(nullptr);
+    auto parser = arguably::create_parser().multi<'I', "include", "", std::string_view>().create();
+
+    parser.parse(arguments.data());
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'I'>().size(), 1000);
+    EXPECT_EQ(parser.get<'I'>().capacity(), 1000);
+}
+
+TEST(Parser, MultiParameterIsResetBetweenParses) {
+    const char* first_argv[] = { "a.out", "-n", "1", "-n", "2", nullptr };
+    const char* second_argv[] = { "a.out", "-n", "3", nullptr };
+    const char* failing_argv[] = { "a.out", "-n", "x", nullptr };
+    auto parser = arguably::create_parser().multi<'n', "number", "", int>().create();
+
+    parser.parse(first_argv);
+    ASSERT_EQ(parser.get<'n'>(), (std::pmr::vector<int>{ 1, 2 }));
+    parser.parse_fresh(second_argv);
+    EXPECT_EQ(parser.get<'n'>(), (std::pmr::vector<int>{ 3 }));
+    parser.parse_fresh(failing_argv);
+    EXPECT_TRUE(parser.result_is<arguably::result::ArgumentTypeMismatch>());
+}
+
+TEST(Parser, RestParameter) {
+    const char* argv[] = { "a.out", "-v", "input.txt", "a", "-b", "--c", nullptr };
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .optionally_named<'i', "input", "", std::string_view>("-")
+                          .rest<'f', "files", "">()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'i'>(), "input.txt");
+    ASSERT_TRUE(parser.was_provided<'f'>());
+    const auto files = parser.get<'f'>();
+    EXPECT_EQ(files.data(), argv + 3);
+    EXPECT_EQ(files.size(), 3);
+}
+
+TEST(Parser, RestParameterAfterNamedPositional) {
+    const char* argv[] = { "a.out", "--input", "input.txt", "a", "--", "b", nullptr };
+    auto parser = arguably::create_parser()
+                          .optionally_named<'i', "input", "", std::string_view>("-")
+                          .rest<'f', "files", "">()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'i'>(), "input.txt");
+    const auto files = parser.get<'f'>();
+    ASSERT_EQ(files.size(), 3);
+    EXPECT_EQ(std::string_view{ files[0] }, "a");
+    EXPECT_EQ(std::string_view{ files[1] }, "--");
+    EXPECT_EQ(std::string_view{ files[2] }, "b");
+}
+
+TEST(Parser, RestParameterStartingWithDash) {
+    const char* argv[] = { "a.out", "-", "-", "x", nullptr };
+    auto parser = arguably::create_parser()
+                          .optionally_named<'i', "input", "", std::string_view>("")
+                          .rest<'f', "files", "">()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'i'>(), "-");
+    EXPECT_EQ(parser.get<'f'>().size(), 2);
+    EXPECT_EQ(parser.get<'f'>().data(), argv + 2);
+}
+
+TEST(Parser, RestParameterIsEmptyIfNotGiven) {
+    const char* argv[] = { "a.out", "input.txt", nullptr };
+    auto parser = arguably::create_parser()
+                          .optionally_named<'i', "input", "", std::string_view>("-")
+                          .rest<'f', "files", "">()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_FALSE(parser.was_provided<'f'>());
+    EXPECT_TRUE(parser.get<'f'>().empty());
+}
+
+TEST(Parser, RestParameterCannotBeSetByName) {
+    const char* short_argv[] = { "a.out", "-f", "x", nullptr };
+    const char* long_argv[] = { "a.out", "--files=x", nullptr };
+    const auto schema = arguably::create_parser().rest<'f', "files", "">().create_schema();
+
+    EXPECT_TRUE(schema.parse(short_argv).result_is<arguably::result::UnknownOption>());
+    EXPECT_TRUE(schema.parse(long_argv).result_is<arguably::result::UnknownOption>());
+}
+
+TEST(Parser, RestParameterFromCommandLineString) {
+    const auto schema = arguably::create_parser().flag<'v', "verbose", "">().rest<'f', "files", "">().create_schema();
+
+    const auto parsed = schema.parse("-v a 'b c' -d");
+
+    ASSERT_TRUE(parsed);
+    const auto files = parsed.get<'f'>();
+    ASSERT_EQ(files.size(), 3);
+    EXPECT_EQ(std::string_view{ files[0] }, "a");
+    EXPECT_EQ(std::string_view{ files[1] }, "b c");
+    EXPECT_EQ(std::string_view{ files[2] }, "-d");
+}
+
+TEST(Parser, LazyConversionHappensOnFirstAccess) {
+    num_expensive_conversions = 0;
+    const char* argv[] = { "a.out", "--first=1", "-s", "2", "3", nullptr };
+    auto parser = arguably::create_parser()
+                          .named<'f', "first", "", ExpensiveValue>({ 10 })
+                          .named<'s', "second", "", ExpensiveValue>({ 20 })
+                          .named<'n', "not_given", "", ExpensiveValue>({ 30 })
+                          .optionally_named<'t', "third", "", ExpensiveValue>({ 40 })
+                          .create();
+
+    parser.parse(argv);
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(num_expensive_conversions, 0);
+
+    EXPECT_EQ(parser.get<'s'>().value, 2);
+    EXPECT_EQ(parser.get<'s'>().value, 2);
+    EXPECT_EQ(num_expensive_conversions, 1);
+    EXPECT_EQ(parser.get<'n'>().value, 30);
+    EXPECT_EQ(num_expensive_conversions, 1);
+
+    EXPECT_TRUE(parser.validate_all());
+    EXPECT_EQ(num_expensive_conversions, 3);
+    EXPECT_EQ(parser.get<'f'>().value, 1);
+    EXPECT_EQ(parser.get<'t'>().value, 3);
+    EXPECT_EQ(num_expensive_conversions, 3);
+}
+
+template<typename Result>
+concept CanGetFirstFromConstResult = requires(const Result& result) { result.template get<'f'>(); };
+
+TEST(Parser, LazyValuesNeedANonConstResult) {
+    using Result = decltype(arguably::create_parser()
+                                    .named<'f', "first", "", ExpensiveValue>({ 10 })
+                                    .named<'s', "second", "", int>(20)
+                                    .create_schema())::Result;
+    using EagerResult = decltype(arguably::create_parser().named<'f', "first", "", int>(10).create_schema())::Result;
+
+    // converting a value on access modifies the result, so a const result (that may be shared) cannot do it
+    static_assert(not CanGetFirstFromConstResult<Result>);
+    static_assert(CanGetFirstFromConstResult<EagerResult>);
+    static_assert(requires(Result& result) { result.template get<'f'>(); });
+    static_assert(requires(const Result& result) { result.template get<'s'>(); });
+}
+
+TEST(Parser, LazyConversionReportsTypeMismatchOnAccess) {
+    const char* argv[] = { "a.out", "--first=one", "--second=two", nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'f', "first", "", ExpensiveValue>({ 10 })
+                                .named<'s', "second", "", ExpensiveValue>({ 20 })
+                                .create_schema();
+
+    auto parsed = schema.parse(argv);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'f'>().value, 10);
+    EXPECT_TRUE(parsed.result_is<arguably::result::ArgumentTypeMismatch>());
+
+    auto validated = schema.parse(argv);
+    EXPECT_FALSE(validated.validate_all());
+    EXPECT_TRUE(validated.result_is<arguably::result::ArgumentTypeMismatch>());
+    EXPECT_EQ(validated.get<'s'>().value, 20);
+
+    const char* valid_argv[] = { "a.out", "--first=1", nullptr };
+    schema.parse_into(validated, valid_argv);
+    EXPECT_TRUE(validated.validate_all());
+    EXPECT_EQ(validated.get<'f'>().value, 1);
+    EXPECT_EQ(validated.get<'s'>().value, 20);
+}
+
+TEST(Parser, DashFollowedByMoreArguments) {
+    const char* argv[] = { "a.out", "-", "x", nullptr };
+    auto parser = arguably::create_parser()
+                          .optionally_named<'a', "first", "", std::string>("")
+                          .optionally_named<'b', "second", "", std::string>("")
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'a'>(), "-");
+    EXPECT_EQ(parser.get<'b'>(), "x");
+}
+
+TEST(Parser, EmptyArgumentsArePositional) {
+    const char* argv[] = { "a.out", "", "-v", "dest", nullptr };
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .optionally_named<'i', "input", "", std::string>("-")
+                          .optionally_named<'o', "output", "", std::string>("-")
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'i'>(), "");
+    EXPECT_EQ(parser.get<'o'>(), "dest");
+
+    parser.parse_fresh(R"(-v '' dest)");
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'i'>(), "");
+    EXPECT_EQ(parser.get<'o'>(), "dest");
+
+    const char* empty_last_value[] = { "a.out", "in", "--output", "", nullptr };
+    parser.parse_fresh(empty_last_value);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'o'>(), "");
+
+    const char* too_many[] = { "a.out", "in", "out", "", nullptr };
+    parser.parse_fresh(too_many);
+
+    EXPECT_TRUE(parser.result_is<arguably::result::ExcessUnnamedArguments>());
+}
+
+TEST(Parser, ResponseFile) {
+    const auto path = write_temporary_file("arguably_response_file.txt", "-v\n  --output  result.txt\r\n\t-n7 ");
+    const auto response_argument = "@" + path;
+    const char* argv[] = { "a.out", response_argument.c_str(), "input.txt", nullptr };
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string_view>("a.out")
+                          .named<'n', "count", "", int>(1)
+                          .optionally_named<'f', "file", "", std::string_view>("-")
+                          .response_files()
+                          .create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'o'>(), "result.txt");
+    EXPECT_EQ(parser.get<'n'>(), 7);
+    EXPECT_EQ(parser.get<'f'>(), "input.txt");
+    std::filesystem::remove(path);
+}
+
+TEST(Parser, ResponseFileValuesOutliveTheParse) {
+    const auto path = write_temporary_file("arguably_response_file_lifetime.txt", "--output result.txt");
+    const auto response_argument = "@" + path;
+    const char* argv[] = { "a.out", response_argument.c_str(), nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'o', "output", "", std::string_view>("a.out")
+                                .response_files()
+                                .create_schema();
+
+    auto parsed = schema.parse(argv);
+    const auto copy = parsed;
+    schema.reset(parsed);
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(copy.get<'o'>(), "result.txt");
+    EXPECT_EQ(parsed.get<'o'>(), "a.out");
+}
+
+TEST(Parser, ResponseFileWordsAreQuoted) {
+    const auto path = write_temporary_file(
+            "arguably_response_file_quoted.txt", "--output 'a file name with spaces.txt' \"an \\\"input\\\"\" @other\n"
+    );
+    const auto response_argument = "@" + path;
+    const char* argv[] = { "a.out", response_argument.c_str(), nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'o', "output", "", std::string_view>("a.out")
+                                .optionally_named<'f', "file", "", std::string_view>("-")
+                                .optionally_named<'s', "second", "", std::string_view>("-")
+                                .response_files()
+                                .create_schema();
+
+    const auto parsed = schema.parse(argv);
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'o'>(), "a file name with spaces.txt");
+    EXPECT_EQ(parsed.get<'f'>(), "an \"input\"");
+    // response files do not include other response files
+    EXPECT_EQ(parsed.get<'s'>(), "@other");
+}
+
+TEST(Parser, ResponseFilesAreOptIn) {
+    const auto path = write_temporary_file("arguably_response_file_opt_in.txt", "--output result.txt");
+    const auto response_argument = "@" + path;
+    const char* argv[] = { "a.out", response_argument.c_str(), nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'o', "output", "", std::string_view>("a.out")
+                                .optionally_named<'f', "file", "", std::string_view>("-")
+                                .create_schema();
+
+    const auto parsed = schema.parse(argv);
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'o'>(), "a.out");
+    EXPECT_EQ(parsed.get<'f'>(), response_argument);
+}
+
+TEST(Parser, ValuesAndArgumentsAfterDoubleDashAreNoResponseFiles) {
+    const char* argv[] = { "a.out", "--name", "@handle", "-n@other", "--", "@this/file/does/not/exist", nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'n', "name", "", std::string_view>("")
+                                .optionally_named<'f', "file", "", std::string_view>("-")
+                                .response_files()
+                                .create_schema();
+
+    const auto parsed = schema.parse(argv);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'n'>(), "@other");
+    EXPECT_EQ(parsed.get<'f'>(), "@this/file/does/not/exist");
+
+    const char* value_argv[] = { "a.out", "--name", "@handle", nullptr };
+    const auto value = schema.parse(value_argv);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(value.get<'n'>(), "@handle");
+}
+
+TEST(Parser, MissingResponseFile) {
+    const char* argv[] = { "a.out", "-n", "2", "@this/file/does/not/exist", nullptr };
+    auto parser = arguably::create_parser().named<'n', "count", "", int>(1).response_files().create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser.result_is<arguably::result::CannotOpenResponseFile>());
+    EXPECT_EQ(
+            std::get<arguably::result::CannotOpenResponseFile>(parser.result()).path, "this/file/does/not/exist"
+    );
+}
+
+TEST(Parser, SingleAtSignIsNotAResponseFile) {
+    const char* argv[] = { "a.out", "@", nullptr };
+    auto parser = arguably::create_parser().optionally_named<'f', "file", "", std::string>("-").create();
+
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'f'>(), "@");
+}
+
+TEST(Parser, ConfigFile) {
+    const auto path = write_temporary_file(
+            "arguably_config_file.conf",
+            "# generated defaults\n"
+            "output = from_config.txt\r\n"
+            "\n"
+            "  count=3\n"
+            "verbose = true\n"
+            "include = a\n"
+            "include = b\n"
+            "level = 1\n"
+            "level = 2"
+    );
+    const char* argv[] = { "a.out", "--count", "5", nullptr };
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string_view>("a.out")
+                          .named<'n', "count", "", int>(1)
+                          .named<'l', "level", "", int>(0)
+                          .multi<'I', "include", "", std::string>()
+                          .create();
+
+    parser.parse(argv);
+    parser.parse_config(path.c_str());
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'o'>(), "from_config.txt");
+    EXPECT_EQ(parser.get<'n'>(), 5);
+    EXPECT_EQ(parser.get<'l'>(), 2);
+    EXPECT_EQ(parser.get<'I'>(), (std::pmr::vector<std::string>{ "a", "b" }));
+}
+
+TEST(Parser, ConfigFileDoesNotOverrideMultiParametersFromTheCommandLine) {
+    const auto path = write_temporary_file("arguably_config_file_multi.conf", "include = from_config\n");
+    const char* argv[] = { "a.out", "-I", "from_argv", nullptr };
+    const auto schema = arguably::create_parser().multi<'I', "include", "", std::string>().create_schema();
+
+    auto parsed = schema.parse(argv);
+    schema.parse_config(parsed, path.c_str());
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'I'>(), (std::pmr::vector<std::string>{ "from_argv" }));
+}
+
+TEST(Parser, InvalidConfigFiles) {
+    const char* argv[] = { "a.out", nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'n', "count", "", int>(1)
+                                .rest<'f', "files", "">()
+                                .create_schema();
+    const auto parse_config = [&](const std::string_view contents) {
+        const auto path = write_temporary_file("arguably_invalid_config_file.conf", contents);
+        auto parsed = schema.parse(argv);
+        schema.parse_config(parsed, path.c_str());
+        std::filesystem::remove(path);
+        return parsed;
+    };
+
+    const auto invalid_line = parse_config("count = 2\n\n# comment\ncount 3\n");
+    ASSERT_TRUE(invalid_line.result_is<arguably::result::InvalidConfigLine>());
+    EXPECT_EQ(std::get<arguably::result::InvalidConfigLine>(invalid_line.result()).line, 4);
+
+    const auto unknown_option = parse_config("unknown = 2\n");
+    ASSERT_TRUE(unknown_option.result_is<arguably::result::UnknownOption>());
+    EXPECT_EQ(
+            std::get<std::pmr::string>(std::get<arguably::result::UnknownOption>(unknown_option.result()).option),
+            "unknown"
+    );
+
+    EXPECT_TRUE(parse_config("files = a b\n").result_is<arguably::result::UnknownOption>());
+    EXPECT_TRUE(parse_config("count =\n").result_is<arguably::result::MissingArgument>());
+    EXPECT_TRUE(parse_config("count = many\n").result_is<arguably::result::ArgumentTypeMismatch>());
+
+    auto parsed = schema.parse(argv);
+    schema.parse_config(parsed, "this/file/does/not/exist");
+    ASSERT_TRUE(parsed.result_is<arguably::result::CannotOpenConfigFile>());
+    EXPECT_EQ(std::get<arguably::result::CannotOpenConfigFile>(parsed.result()).path, "this/file/does/not/exist");
+}
+
+TEST(Parser, ParseCommandLineString) {
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string_view>("a.out")
+                          .named<'n', "count", "", int>(1)
+                          .optionally_named<'f', "file", "", std::string_view>("-")
+                          .optionally_named<'g', "other", "", std::string_view>("-")
+                          .create();
+    const auto command_line = std::string{ "  -v --output=x\t-n 7 file1 file2  " };
+
+    parser.parse(command_line);
+
+    ASSERT_TRUE(parser);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'o'>(), "x");
+    EXPECT_EQ(parser.get<'n'>(), 7);
+    EXPECT_EQ(parser.get<'f'>(), "file1");
+    EXPECT_EQ(parser.get<'g'>(), "file2");
+    // unquoted words are not copied
+    EXPECT_EQ(parser.get<'f'>().data(), command_line.data() + command_line.find("file1"));
+}
+
+TEST(Parser, ParseCommandLineStringWithQuotes) {
+    const auto schema = arguably::create_parser()
+                                .named<'a', "first", "", std::string>("")
+                                .named<'b', "second", "", std::string>("")
+                                .named<'c', "third", "", std::string>("")
+                                .named<'d', "fourth", "", std::string>("")
+                                .named<'e', "fifth", "", std::string_view>("")
+                                .create_schema();
+
+    const auto parsed = schema.parse(
+            R"(-a 'single "quoted" \n' -b "double \"quoted\" \$HOME \n" -c no\ space"s "'here' -d "" -e "plain")"
+    );
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'a'>(), R"(single "quoted" \n)");
+    EXPECT_EQ(parsed.get<'b'>(), R"(double "quoted" $HOME \n)");
+    EXPECT_EQ(parsed.get<'c'>(), "no spaces here");
+    EXPECT_EQ(parsed.get<'d'>(), "");
+    EXPECT_EQ(parsed.get<'e'>(), "plain");
+}
+
+TEST(Parser, ParseCommandLineStringWithUnterminatedQuote) {
+    const auto schema = arguably::create_parser().named<'o', "output", "", std::string>("").create_schema();
+
+    EXPECT_TRUE(schema.parse("--output 'a b").result_is<arguably::result::UnterminatedQuote>());
+    EXPECT_TRUE(schema.parse("--output=\"a b").result_is<arguably::result::UnterminatedQuote>());
+    EXPECT_TRUE(schema.parse("").result_is<arguably::result::Okay>());
+}
+
+TEST(Parser, ParseCommandLineStringDoesNotExpandResponseFiles) {
+    const auto schema = arguably::create_parser().optionally_named<'f', "file", "", std::string>("").create_schema();
+
+    const auto parsed = schema.parse("@/etc/passwd");
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'f'>(), "@/etc/passwd");
+}
+
+/// sets an environment variable for the lifetime of the object and restores its previous state afterwards
+class ScopedEnvironmentVariable final {
+public:
+    ScopedEnvironmentVariable(const char* const name, const char* const value) : m_name{ name } {
+        if (const auto previous = std::getenv(name)) {
+            m_previous_value = previous;
+        }
+        set(value);
+    }
+
+    ScopedEnvironmentVariable(const ScopedEnvironmentVariable&) = delete;
+    ScopedEnvironmentVariable& operator=(const ScopedEnvironmentVariable&) = delete;
+
+    ~ScopedEnvironmentVariable() {
+        set(m_previous_value ? m_previous_value->c_str() : nullptr);
+    }
+
+private:
+    /// removes the variable if the value is nullptr
+    void set(const char* const value) const {
+#ifdef _WIN32
+        // an empty value removes the variable
+        _putenv_s(m_name, value == nullptr ? "" : value);
+#else
+        if (value == nullptr) {
+            unsetenv(m_name);
+        } else {
+            setenv(m_name, value, 1);
+        }
+#endif
+    }
+
+    const char* m_name;
+    std::optional<std::string> m_previous_value;
+};
+
+TEST(Parser, EnvironmentVariableFallback) {
+    const auto output = ScopedEnvironmentVariable{ "ARGUABLY_TEST_OUTPUT", "from_environment.txt" };
+    const auto level = ScopedEnvironmentVariable{ "ARGUABLY_TEST_LEVEL", "3" };
+    const auto verbose = ScopedEnvironmentVariable{ "ARGUABLY_TEST_VERBOSE", "1" };
+    const char* argv[] = { "a.out", "--level=5", nullptr };
+    auto parser = arguably::create_parser()
+                          .named<'o', "output", "", std::string>("a.out")
+                          .named<'l', "level", "", int>(0)
+                          .flag<'v', "verbose", "">()
+                          .named<'n', "name", "", std::string>("default")
+                          .env<'o', "ARGUABLY_TEST_OUTPUT">()
+                          .env<'l', "ARGUABLY_TEST_LEVEL">()
+                          .env<'v', "ARGUABLY_TEST_VERBOSE">()
+                          .create();
+    parser.parse(argv);
+
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(parser.get<'o'>(), "from_environment.txt");
+    EXPECT_TRUE(parser.was_provided<'o'>());
+    EXPECT_EQ(parser.get<'l'>(), 5);
+    EXPECT_TRUE(parser.get<'v'>());
+    EXPECT_EQ(parser.get<'n'>(), "default");
+    EXPECT_FALSE(parser.was_provided<'n'>());
+
+    parser.reset();
+    EXPECT_EQ(parser.get<'o'>(), "a.out");
+    EXPECT_FALSE(parser.get<'v'>());
+}
+
+TEST(Parser, EnvironmentVariableTypeMismatch) {
+    const auto number = ScopedEnvironmentVariable{ "ARGUABLY_TEST_NUMBER", "not a number" };
+    const char* argv[] = { "a.out", nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'n', "number", "", int>(0)
+                                .env<'n', "ARGUABLY_TEST_NUMBER">()
+                                .create_schema();
+    EXPECT_TRUE(schema.parse(argv).result_is<arguably::result::ArgumentTypeMismatch>());
+
+    const char* argv_with_number[] = { "a.out", "-n", "42", nullptr };
+    const auto parsed = schema.parse(argv_with_number);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'n'>(), 42);
+}
+
+TEST(Parser, EmptyEnvironmentVariableIsIgnored) {
+#ifdef _WIN32
+    GTEST_SKIP() << "an empty value removes the variable on Windows, so it cannot be set but empty";
+#else
+    const auto empty = ScopedEnvironmentVariable{ "ARGUABLY_TEST_EMPTY", "" };
+    const char* argv[] = { "a.out", nullptr };
+    const auto parsed = arguably::create_parser()
+                                .named<'n', "number", "", int>(7)
+                                .env<'n', "ARGUABLY_TEST_EMPTY">()
+                                .create_schema()
+                                .parse(argv);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'n'>(), 7);
+    EXPECT_FALSE(parsed.was_provided<'n'>());
+#endif
+}
+
+TEST(Parser, CountingObserver) {
+    const char* argv[] = { "a.out", "-vo", "out.txt", "--count=3", "--name", "x", "in", nullptr };
+    const char* failing_argv[] = { "a.out", "--count=three", nullptr };
+    auto parser = arguably::create_parser()
+                          .flag<'v', "verbose", "">()
+                          .named<'o', "output", "", std::string>("a.out")
+                          .named<'c', "count", "", int>(1)
+                          .named<'n', "name", "", std::string_view>("")
+                          .optionally_named<'i', "input", "", std::string>("")
+                          .create();
+    auto observer = arguably::CountingObserver{};
+
+    parser.parse(argv, observer);
+    ASSERT_TRUE(parser);
+    EXPECT_EQ(observer.parses, 1);
+    EXPECT_EQ(observer.tokens, 6);
+    EXPECT_EQ(observer.options, 5);
+    EXPECT_EQ(observer.conversions, 4);
+    // only the strings are copies, the int is converted and the std::string_view points into argv
+    EXPECT_EQ(observer.bytes_copied, std::string_view{ "out.txtin" }.size());
+    EXPECT_EQ(observer.errors, 0);
+
+    parser.parse(argv, observer);
+    EXPECT_TRUE(parser.result_is<arguably::result::CannotParseAgain>());
+    EXPECT_EQ(observer.errors, 1);
+
+    const auto parsed = parser.schema().parse(failing_argv, observer);
+    EXPECT_TRUE(parsed.result_is<arguably::result::ArgumentTypeMismatch>());
+    EXPECT_EQ(observer.parses, 2);
+    EXPECT_EQ(observer.errors, 2);
+}
+
+TEST(Schema, CountingObserverCountsAllocationsOfTheResult) {
+    const char* argv[] = { "a.out", "-Ia", "--include=b", nullptr };
+    const auto schema = arguably::create_parser().multi<'I', "include", "", std::pmr::string>().create_schema();
+    auto observer = arguably::CountingObserver{};
+
+    const auto parsed = schema.parse(argv, observer, &observer.resource);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'I'>().size(), 2);
+    EXPECT_EQ(observer.allocations(), 1);
+    EXPECT_GE(observer.resource.bytes_allocated(), 2 * sizeof(std::pmr::string));
+}
+
+TEST(Schema, ObserverSeesTheTokensAndOptionsInOrder) {
+    struct RecordingObserver : arguably::Observer {
+        std::vector<std::string> events;
+
+        void on_token(const std::string_view token) {
+            events.push_back("token " + std::string{ token });
+        }
+
+        void on_option(const std::size_t index) {
+            events.push_back("option " + std::to_string(index));
+        }
+
+        void on_error(const arguably::detail::ParseResult&) {
+            events.push_back("error");
+        }
+    };
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .optionally_named<'i', "input", "", std::string>("")
+                                .create_schema();
+    auto observer = RecordingObserver{};
+
+    const auto parsed = schema.parse("--verbose -- in.txt --unknown", observer);
+
+    EXPECT_TRUE(parsed.result_is<arguably::result::ExcessUnnamedArguments>());
+    const auto expected = std::vector<std::string>{
+        "token --verbose", "option 1", "token --", "token in.txt", "option 2", "token --unknown", "error"
+    };
+    EXPECT_EQ(observer.events, expected);
+}
+
+TEST(Schema, TimingObserver) {
+    const char* argv[] = { "a.out", "--count=3", nullptr };
+    const auto schema = arguably::create_parser().named<'c', "count", "", int>(1).create_schema();
+    auto observer = arguably::TimingObserver{};
+
+    const auto parsed = schema.parse(argv, observer);
+    ASSERT_TRUE(parsed);
+    EXPECT_GT(observer.parse_time.count(), 0);
+    EXPECT_GE(observer.parse_time, observer.conversion_time);
+}
+
+TEST(Schema, ParseReturnsIndependentResults) {
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .named<'o', "output", "", std::string>("a.out")
+                                .create_schema();
+    const char* first_argv[] = { "a.out", "-v", nullptr };
+    const char* second_argv[] = { "a.out", "--output=result.txt", nullptr };
+
+    const auto first = schema.parse(first_argv);
+    const auto second = schema.parse(second_argv);
+
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_TRUE(first.get<'v'>());
+    EXPECT_EQ(first.get<'o'>(), "a.out");
+    EXPECT_FALSE(second.get<'v'>());
+    EXPECT_EQ(second.get<'o'>(), "result.txt");
+    EXPECT_TRUE(second.was_provided<'o'>());
+}
+
+TEST(Schema, ParseIntoResetsTheResult) {
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .named<'n', "count", "", int>(1)
+                                .create_schema();
+    const char* first_argv[] = { "a.out", "-v", "-n", "3", nullptr };
+    const char* second_argv[] = { "a.out", nullptr };
+
+    auto parsed = schema.parse(first_argv);
+    ASSERT_TRUE(parsed);
+
+    schema.parse_into(parsed, second_argv);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_FALSE(parsed.get<'v'>());
+    EXPECT_EQ(parsed.get<'n'>(), 1);
+}
+
+TEST(Schema, ParserExposesItsSchema) {
+    auto parser = arguably::create_parser().named<'n', "count", "", int>(1).create();
+    const char* argv[] = { "a.out", "-n", "5", nullptr };
+
+    const auto parsed = parser.schema().parse(argv);
+
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(parsed.get<'n'>(), 5);
+    EXPECT_TRUE(parser.result_is<arguably::result::NothingParsedYet>());
+}
+
+TEST(Schema, ConcurrentParsing) {
+    const auto schema = arguably::create_parser()
+                                .named<'n', "count", "", int>(0)
+                                .named<'o', "output", "", std::string>("")
+                                .create_schema();
+
+    auto results = std::vector<int>(8, -1);
+    auto threads = std::vector<std::thread>{};
+    for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+        threads.emplace_back([&schema, &results, i] {
+            const auto number = std::to_string(i);
+            for (int repetition = 0; repetition < 1000; ++repetition) {
+                const char* argv[] = { "a.out", "-n", number.c_str(), "--output=file", nullptr };
+                const auto parsed = schema.parse(argv);
+                if (not parsed or parsed.get<'o'>() != "file") {
+                    return;
+                }
+                results[static_cast<std::size_t>(i)] = parsed.get<'n'>();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+        EXPECT_EQ(results[static_cast<std::size_t>(i)], i);
+    }
+}
+
+TEST(Schema, Subcommands) {
+    const auto commands =
+            arguably::create_subcommands()
+                    .subcommand<"build">(arguably::create_parser()
+                                                 .named<'j', "jobs", "", int>(1)
+                                                 .optionally_named<'t', "target", "", std::string>("all"))
+                    .subcommand<"test">(arguably::create_parser().flag<'f', "fail_fast", "">())
+                    .create();
+    using Commands = std::remove_const_t<decltype(commands)>;
+
+    const char* build_argv[] = { "tool", "build", "-j", "4", "install", nullptr };
+    const auto build = commands.parse(build_argv);
+    ASSERT_EQ(build.index(), Commands::index_of<"build">());
+    const auto build_result = Commands::get_if<"build">(build);
+    ASSERT_NE(build_result, nullptr);
+    ASSERT_TRUE(*build_result);
+    EXPECT_EQ(build_result->get<'j'>(), 4);
+    EXPECT_EQ(build_result->get<'t'>(), "install");
+    EXPECT_EQ(Commands::get_if<"test">(build), nullptr);
+
+    const char* test_argv[] = { "tool", "test", "--fail_fast", nullptr };
+    const auto test = commands.parse(test_argv);
+    ASSERT_NE(Commands::get_if<"test">(test), nullptr);
+    EXPECT_TRUE(Commands::get_if<"test">(test)->get<'f'>());
+
+    const char* invalid_argv[] = { "tool", "test", "--jobs=4", nullptr };
+    EXPECT_TRUE(Commands::get_if<"test">(commands.parse(invalid_argv))->result_is<arguably::result::UnknownOption>());
+}
+
+TEST(Schema, UnknownSubcommand) {
+    const auto commands = arguably::create_subcommands()
+                                  .subcommand<"build">(arguably::create_parser().named<'j', "jobs", "", int>(1))
+                                  .create();
+
+    const char* unknown_argv[] = { "tool", "--jobs=4", nullptr };
+    const auto unknown = commands.parse(unknown_argv);
+    ASSERT_EQ(unknown.index(), 0);
+    EXPECT_EQ(std::get<arguably::result::UnknownSubcommand>(unknown).name, "--jobs=4");
+
+    const char* missing_argv[] = { "tool", nullptr };
+    const auto missing = commands.parse(missing_argv);
+    ASSERT_EQ(missing.index(), 0);
+    EXPECT_TRUE(std::get<arguably::result::UnknownSubcommand>(missing).name.empty());
+}
+
+TEST(Schema, ParseBatchKeepsInputOrder) {
+    const auto schema = arguably::create_parser().named<'n', "count", "", int>(-1).create_schema();
+    auto numbers = std::vector<std::string>{};
+    for (int i = 0; i < 5000; ++i) {
+        numbers.push_back(std::to_string(i));
+    }
+    auto argument_vectors = std::vector<std::vector<const char*>>{};
+    for (const auto& number : numbers) {
+        argument_vectors.push_back({ "a.out", "-n", number.c_str(), nullptr });
+    }
+    argument_vectors[500] = { "a.out", "-x", nullptr };
+    auto argvs = std::vector<const char**>{};
+    for (auto& argument_vector : argument_vectors) {
+        argvs.push_back(argument_vector.data());
+    }
+
+    const auto results = schema.parse_batch(argvs, 4);
+
+    ASSERT_EQ(results.size(), 5000);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (i == 500) {
+            EXPECT_TRUE(results[i].result_is<arguably::result::UnknownOption>());
+        } else {
+            ASSERT_TRUE(results[i]);
+            EXPECT_EQ(results[i].get<'n'>(), static_cast<int>(i));
+        }
+    }
+}
+
+TEST(Schema, CopyIntoMemoryResource) {
+    const char* argv[] = { "a.out", "-I", "a/rather/long/include/directory/name", "--output=b.txt", nullptr };
+    const char* failing_argv[] = { "a.out", "--an-unknown-option-with-a-rather-long-name", nullptr };
+    const auto schema = arguably::create_parser()
+                                .named<'o', "output", "", std::pmr::string>(std::pmr::string{})
+                                .multi<'I', "include", "", std::pmr::string>()
+                                .create_schema();
+    using Result = std::remove_const_t<decltype(schema)>::Result;
+    const auto parsed = schema.parse(argv);
+    const auto failed = schema.parse(failing_argv);
+    auto resource = arguably::CountingResource{};
+
+    const auto copy = Result{ std::allocator_arg, &resource, parsed };
+    const auto copied_error = Result{ std::allocator_arg, &resource, failed };
+
+    EXPECT_GT(resource.allocations(), 0);
+    EXPECT_EQ(copy.get_allocator().resource(), &resource);
+    EXPECT_EQ(copy.get<'I'>().get_allocator().resource(), &resource);
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(copy.get<'o'>(), "b.txt");
+    ASSERT_EQ(copy.get<'I'>().size(), 1);
+    EXPECT_EQ(copy.get<'I'>().front(), "a/rather/long/include/directory/name");
+    ASSERT_TRUE(copied_error.result_is<arguably::result::UnknownOption>());
+    const auto& option = std::get<arguably::result::UnknownOption>(copied_error.result()).option;
+    EXPECT_EQ(std::get<std::pmr::string>(option).get_allocator().resource(), &resource);
+
+    // containers of results pass on their resource
+    auto results = std::pmr::vector<Result>{ &resource };
+    results.push_back(parsed);
+    EXPECT_EQ(results.front().get<'I'>().get_allocator().resource(), &resource);
+}
+
+TEST(Schema, ParseLines) {
+    const auto schema = arguably::create_parser()
+                                .flag<'v', "verbose", "">()
+                                .named<'o', "output", "", std::string_view>("-")
+                                .optionally_named<'f', "file", "", std::string_view>("")
+                                .create_schema();
+    const auto manifest = std::string{ "-v --output=a.txt input.txt\n"
+                                       "\n"
+                                       "  --output b.txt\t other.txt  \r\n"
+                                       "-q\n"
+                                       "--output 'my file.txt' \"an \\\"input\\\"\"" };
+
+    const auto results = schema.parse_lines(manifest, 2);
+
+    ASSERT_EQ(results.size(), 5);
+    ASSERT_TRUE(results[0]);
+    EXPECT_TRUE(results[0].get<'v'>());
+    EXPECT_EQ(results[0].get<'o'>(), "a.txt");
+    EXPECT_EQ(results[0].get<'f'>(), "input.txt");
+    ASSERT_TRUE(results[1]);
+    EXPECT_EQ(results[1].get<'o'>(), "-");
+    ASSERT_TRUE(results[2]);
+    EXPECT_FALSE(results[2].get<'v'>());
+    EXPECT_EQ(results[2].get<'o'>(), "b.txt");
+    EXPECT_EQ(results[2].get<'f'>(), "other.txt");
+    EXPECT_TRUE(results[3].result_is<arguably::result::UnknownOption>());
+    // the lines are split like by parse(std::string_view)
+    const auto quoted = schema.parse(std::string_view{ manifest }.substr(manifest.rfind('\n') + 1));
+    ASSERT_TRUE(results[4]);
+    EXPECT_EQ(results[4].get<'o'>(), "my file.txt");
+    EXPECT_EQ(results[4].get<'f'>(), "an \"input\"");
+    EXPECT_EQ(results[4].get<'o'>(), quoted.get<'o'>());
+    EXPECT_EQ(results[4].get<'f'>(), quoted.get<'f'>());
+}